@@ -0,0 +1,118 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "Test.hpp"
+
+namespace EVA::TEST
+{
+    // Counts the allocations the calling thread makes in the body of EXPECT_NO_ALLOC or EXPECT_MAX_ALLOCS. The macros loop
+    // over the scope: the first pass runs the body, the second checks the count.
+    class AllocationScope
+    {
+        uint64_t m_Max;
+        uint64_t m_Start    = 0;
+        uint64_t m_Bytes    = 0;
+        uint64_t m_Count    = 0;
+        uint64_t m_Previous = 0;
+        int m_Pass          = 0;
+
+      public:
+        explicit AllocationScope(uint64_t max) : m_Max(max) {}
+
+        bool Next()
+        {
+            switch (m_Pass++)
+            {
+                case 0:
+                    if (FunctionMap::GetOptions().allocationBacktrace)
+                    {
+                        m_Previous = Allocations::Trap(Allocations::Count() + m_Max + 1);
+                    }
+                    m_Start = Allocations::Count();
+                    m_Bytes = Allocations::Bytes();
+                    return true;
+                case 1:
+                    m_Count = Allocations::Count() - m_Start;
+                    m_Bytes = Allocations::Bytes() - m_Bytes;
+                    if (FunctionMap::GetOptions().allocationBacktrace)
+                    {
+                        Allocations::Trap(m_Previous);
+                    }
+                    return true;
+                default: return false;
+            }
+        }
+
+        bool Checked() const { return m_Pass == 2; }
+        bool Exceeded() const { return m_Count > m_Max; }
+
+        EVA_TEST_COLD void Report(int line, const char* prefix) const
+        {
+            auto& out = ReportBuffer::Begin(line);
+            out << prefix;
+            if (m_Max == 0)
+            {
+                out << "Expected no allocations";
+            }
+            else
+            {
+                out << "Expected at most " << m_Max << " allocations";
+            }
+            out << ", got " << m_Count << " (" << m_Bytes << " bytes)";
+
+#if EVA_TEST_HAS_BACKTRACE
+            void* const* frames;
+            int size = Allocations::Trace(m_Start + m_Max + 1, frames);
+            if (size > 0)
+            {
+                out << "\n    First allocation over the limit:";
+                char** symbols = backtrace_symbols(frames, size);
+
+                // Skips the frames of the allocation hook, and the forms of operator new that forward to it where their
+                // symbols are exported
+                int first = std::min(Allocations::s_HookFrames, size);
+                while (symbols && first < size && (std::strstr(symbols[first], "_Znw") || std::strstr(symbols[first], "_Zna")))
+                {
+                    first++;
+                }
+                for (int i = first; symbols && i < size; i++)
+                {
+                    out << "\n      " << symbols[i];
+                }
+                std::free(symbols);
+            }
+#endif
+            ReportBuffer::End();
+        }
+    };
+} // namespace EVA::TEST
+
+#define EXPECT_MAX_ALLOCS(N)                                                                                                               \
+    for (EVA::TEST::AllocationScope evaTestAllocations(N); evaTestAllocations.Next();)                                                     \
+        if (evaTestAllocations.Checked())                                                                                                  \
+        {                                                                                                                                  \
+            if (EVA_TEST_UNLIKELY(evaTestAllocations.Exceeded()))                                                                          \
+            {                                                                                                                              \
+                Fail();                                                                                                                    \
+                evaTestAllocations.Report(__LINE__, "");                                                                                   \
+            }                                                                                                                              \
+        }                                                                                                                                  \
+        else
+#define EXPECT_NO_ALLOC EXPECT_MAX_ALLOCS(0)
+
+#define ASSERT_MAX_ALLOCS(N)                                                                                                               \
+    for (EVA::TEST::AllocationScope evaTestAllocations(N); evaTestAllocations.Next();)                                                     \
+        if (evaTestAllocations.Checked())                                                                                                  \
+        {                                                                                                                                  \
+            if (EVA_TEST_UNLIKELY(evaTestAllocations.Exceeded()))                                                                          \
+            {                                                                                                                              \
+                Fail();                                                                                                                    \
+                evaTestAllocations.Report(__LINE__, "Assertion failed. ");                                                                 \
+                return;                                                                                                                    \
+            }                                                                                                                              \
+        }                                                                                                                                  \
+        else
+#define ASSERT_NO_ALLOC ASSERT_MAX_ALLOCS(0)
@@ -0,0 +1,84 @@
+#pragma once
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <string>
+
+namespace EVA::TEST
+{
+    // Nanoseconds for a whole test, or per iteration for a benchmark
+    struct Measurement
+    {
+        double median  = 0;
+        double mean    = 0;
+        double stddev  = 0;
+        size_t samples = 0;
+    };
+
+    // Measurements from an earlier run, keyed by "category::name". Stored as text, one "key median mean stddev samples"
+    // entry per line.
+    class Baseline
+    {
+        std::map<std::string, Measurement> m_Entries;
+
+      public:
+        bool Load(const std::string& path)
+        {
+            std::ifstream file(path);
+            if (!file)
+            {
+                return false;
+            }
+            std::string key;
+            Measurement measurement;
+            while (file >> key >> measurement.median >> measurement.mean >> measurement.stddev >> measurement.samples)
+            {
+                m_Entries[key] = measurement;
+            }
+            return true;
+        }
+
+        bool Save(const std::string& path) const
+        {
+            std::ofstream file(path, std::ios::trunc);
+            file.precision(17);
+            for (const auto& [key, measurement] : m_Entries)
+            {
+                file << key << ' ' << measurement.median << ' ' << measurement.mean << ' ' << measurement.stddev << ' ' << measurement.samples
+                     << '\n';
+            }
+            return static_cast<bool>(file);
+        }
+
+        const Measurement* Find(const std::string& key) const
+        {
+            auto it = m_Entries.find(key);
+            return it == m_Entries.end() ? nullptr : &it->second;
+        }
+
+        void Set(const std::string& key, const Measurement& measurement) { m_Entries[key] = measurement; }
+
+        // True when the median slowed down by more than the threshold and the slowdown is significant. With several
+        // samples on both sides that is a one-sided Welch's t-test at p < 0.01; single samples have to be at least a
+        // millisecond slower.
+        static bool Regressed(const Measurement& baseline, const Measurement& current, double threshold)
+        {
+            if (current.median <= baseline.median * (1 + threshold))
+            {
+                return false;
+            }
+
+            if (baseline.samples < 2 || current.samples < 2)
+            {
+                return current.median - baseline.median >= 1e6;
+            }
+
+            double error = std::sqrt(baseline.stddev * baseline.stddev / baseline.samples + current.stddev * current.stddev / current.samples);
+            if (error == 0)
+            {
+                return current.mean > baseline.mean;
+            }
+            return (current.mean - baseline.mean) / error > 2.33;
+        }
+    };
+} // namespace EVA::TEST
@@ -0,0 +1,249 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <vector>
+
+#include "Parameterized.hpp"
+#include "Test.hpp"
+
+namespace EVA::TEST
+{
+#if defined(__GNUC__) || defined(__clang__)
+    template <typename T> inline void DoNotOptimize(const T& value) { asm volatile("" : : "r,m"(value) : "memory"); }
+
+    template <typename T> inline void DoNotOptimize(T& value)
+    {
+    #if defined(__clang__)
+        asm volatile("" : "+r,m"(value) : : "memory");
+    #else
+        asm volatile("" : "+m,r"(value) : : "memory");
+    #endif
+    }
+
+    inline void ClobberMemory() { asm volatile("" : : : "memory"); }
+#else
+    template <typename T> inline void DoNotOptimize(const T& value)
+    {
+        static const void* volatile sink;
+        sink = &value;
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    }
+
+    inline void ClobberMemory() { std::atomic_signal_fence(std::memory_order_seq_cst); }
+#endif
+
+    // Only the loop over the state is timed, so that a benchmark can set up its data in front of it
+    class BenchmarkState
+    {
+        using Clock = std::chrono::steady_clock;
+
+        size_t m_Iterations;
+        Clock::time_point m_Start;
+        Clock::time_point m_Stop;
+
+      public:
+        // What `for (auto _ : state)` yields, empty so that the unused loop variable does not warn
+        struct [[maybe_unused]] Iteration
+        {
+        };
+
+        // Yields an Iteration, or with Counted the number of iterations left, counting down to 1
+        template <bool Counted> struct Iterator
+        {
+            size_t remaining;
+            BenchmarkState* state;
+
+            bool operator!=(const Iterator&)
+            {
+                if (remaining != 0)
+                {
+                    return true;
+                }
+                state->m_Stop = Clock::now();
+                return false;
+            }
+            void operator++() { remaining--; }
+            auto operator*() const
+            {
+                if constexpr (Counted)
+                {
+                    return remaining;
+                }
+                else
+                {
+                    return Iteration{};
+                }
+            }
+        };
+
+        // For the benchmarks that use the iteration, as in `for (auto i : state.Counted())`
+        struct CountedRange
+        {
+            BenchmarkState* state;
+
+            Iterator<true> begin() { return state->Begin<true>(); }
+            Iterator<true> end() { return { 0, state }; }
+        };
+
+        explicit BenchmarkState(size_t iterations) : m_Iterations(iterations) {}
+
+        template <bool Counted> Iterator<Counted> Begin()
+        {
+            m_Start = Clock::now();
+            return { m_Iterations, this };
+        }
+
+        Iterator<false> begin() { return Begin<false>(); }
+        Iterator<false> end() { return { 0, this }; }
+
+        CountedRange Counted() { return { this }; }
+
+        size_t Iterations() const { return m_Iterations; }
+
+        double Elapsed() const { return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(m_Stop - m_Start).count()); }
+    };
+
+    // Nanoseconds per iteration
+    struct BenchmarkStats
+    {
+        size_t iterations = 0;
+        size_t samples    = 0;
+        double min        = 0;
+        double median     = 0;
+        double p99        = 0;
+        double mean       = 0;
+        double stddev     = 0;
+    };
+
+    class Benchmark
+    {
+        using Clock = std::chrono::steady_clock;
+
+        static double Sample(void (*body)(BenchmarkState&), size_t iterations)
+        {
+            BenchmarkState state(iterations);
+            body(state);
+            return state.Elapsed();
+        }
+
+      public:
+        static BenchmarkStats Summarize(std::vector<double> samples, size_t iterations)
+        {
+            BenchmarkStats stats;
+            stats.iterations = iterations;
+            stats.samples    = samples.size();
+            if (samples.empty())
+            {
+                return stats;
+            }
+
+            std::sort(samples.begin(), samples.end());
+            size_t count = samples.size();
+            stats.min    = samples.front();
+            stats.median = count % 2 ? samples[count / 2] : (samples[count / 2 - 1] + samples[count / 2]) / 2;
+            stats.p99    = samples[static_cast<size_t>(std::ceil(0.99 * count)) - 1];
+
+            for (double sample : samples)
+            {
+                stats.mean += sample;
+            }
+            stats.mean /= count;
+
+            for (double sample : samples)
+            {
+                stats.stddev += (sample - stats.mean) * (sample - stats.mean);
+            }
+            stats.stddev = count > 1 ? std::sqrt(stats.stddev / (count - 1)) : 0;
+            return stats;
+        }
+
+        // Picks an iteration count that makes one sample last --benchmark-time, warms up for as long again, and then
+        // takes --benchmark-samples samples. A failure ends the measurement, as every further sample would report it again.
+        static BenchmarkStats Measure(void (*body)(BenchmarkState&))
+        {
+            const auto& options = FunctionMap::GetOptions();
+            double sampleTime   = options.benchmarkTime * 1e6;
+
+            size_t iterations = 1;
+            for (;;)
+            {
+                double ns = Sample(body, iterations);
+                if (FunctionMap::CurrentRunFailed())
+                {
+                    return Summarize({}, iterations);
+                }
+                if (ns >= sampleTime || iterations >= (size_t(1) << 40))
+                {
+                    break;
+                }
+                double scale = ns <= sampleTime / 100 ? 100 : sampleTime / ns * 1.2;
+                iterations   = std::max(iterations + 1, static_cast<size_t>(iterations * scale));
+            }
+
+            for (auto startTime = Clock::now(); Clock::now() - startTime < std::chrono::nanoseconds(static_cast<long long>(sampleTime));)
+            {
+                Sample(body, iterations);
+                if (FunctionMap::CurrentRunFailed())
+                {
+                    return Summarize({}, iterations);
+                }
+            }
+
+            std::vector<double> samples;
+            for (size_t i = 0; i < options.benchmarkSamples && !FunctionMap::CurrentRunFailed(); i++)
+            {
+                samples.push_back(Sample(body, iterations) / iterations);
+            }
+            return Summarize(std::move(samples), iterations);
+        }
+
+        static void Run(void (*body)(BenchmarkState&))
+        {
+            BenchmarkStats stats = Measure(body);
+            if (FunctionMap::CurrentRunFailed())
+            {
+                return;
+            }
+            FunctionMap::Record(Measurement{ stats.median, stats.mean, stats.stddev, stats.samples });
+            FunctionMap::Out() << std::fixed << std::setprecision(2) << "  " << stats.median << " ns median, " << stats.min << " ns min, "
+                               << stats.p99 << " ns p99, " << stats.stddev << " ns stddev (" << stats.samples << " samples of "
+                               << stats.iterations << " iterations)" << std::defaultfloat << std::endl;
+        }
+    };
+} // namespace EVA::TEST
+
+#define BENCHMARK(CATEGORY, NAME)                                                                                                          \
+    struct Benchmark_##CATEGORY##NAME                                                                                                      \
+    {                                                                                                                                      \
+        static void Body(EVA::TEST::BenchmarkState& state);                                                                                \
+        static void Run() { EVA::TEST::Benchmark::Run(&Body); }                                                                            \
+        inline static EVA::TEST::FunctionInfo s_Info = { &Run, #NAME, #CATEGORY, __FILE__ };                                               \
+        Benchmark_##CATEGORY##NAME() { EVA::TEST::FunctionMap::Add(s_Info); }                                                              \
+        inline static void Fail() { EVA::TEST::FunctionMap::Fail(s_Info); }                                                                \
+    };                                                                                                                                     \
+    inline static Benchmark_##CATEGORY##NAME benchmark_##CATEGORY##NAME;                                                                   \
+    void Benchmark_##CATEGORY##NAME::Body(EVA::TEST::BenchmarkState& state)
+
+// One benchmark per type in the list. The body refers to its type as TypeParam.
+#define TYPED_BENCHMARK(CATEGORY, NAME, ...)                                                                                               \
+    struct TypedBenchmarkNames_##CATEGORY##NAME                                                                                            \
+    {                                                                                                                                      \
+        static constexpr std::string_view s_Name  = #NAME;                                                                                 \
+        static constexpr std::string_view s_Types = #__VA_ARGS__;                                                                          \
+        using Types                               = std::tuple<__VA_ARGS__>;                                                               \
+    };                                                                                                                                     \
+    template <size_t I> struct TypedBenchmark_##CATEGORY##NAME                                                                             \
+    {                                                                                                                                      \
+        using TypeParam = std::tuple_element_t<I, TypedBenchmarkNames_##CATEGORY##NAME::Types>;                                            \
+        static void Body(EVA::TEST::BenchmarkState& state);                                                                                \
+        static void Run() { EVA::TEST::Benchmark::Run(&Body); }                                                                            \
+        inline static constexpr auto s_Name          = EVA::TEST::TypedName<TypedBenchmarkNames_##CATEGORY##NAME, I>();                    \
+        inline static EVA::TEST::FunctionInfo s_Info = { &Run, s_Name.View(), #CATEGORY, __FILE__ };                                       \
+        inline static void Fail() { EVA::TEST::FunctionMap::Fail(s_Info); }                                                                \
+    };                                                                                                                                     \
+    inline static EVA::TEST::Instances<TypedBenchmark_##CATEGORY##NAME, std::tuple_size_v<TypedBenchmarkNames_##CATEGORY##NAME::Types>>    \
+        typedBenchmark_##CATEGORY##NAME;                                                                                                   \
+    template <size_t I> void TypedBenchmark_##CATEGORY##NAME<I>::Body(EVA::TEST::BenchmarkState& state)
@@ -0,0 +1,67 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace EVA::TEST
+{
+    // The seeds of the cases that falsified a property, keyed by "category::name". Stored as text, one "key seed" per line.
+    // Read once before the run. New seeds are appended to the file right away, so that isolated workers can add to it.
+    class Corpus
+    {
+        std::map<std::string, std::vector<uint64_t>, std::less<>> m_Seeds;
+        std::string m_Path;
+        std::mutex m_Mutex;
+
+      public:
+        bool Load(const std::string& path)
+        {
+            m_Path = path;
+            std::ifstream file(path);
+            if (!file)
+            {
+                return false;
+            }
+            std::string line;
+            while (std::getline(file, line))
+            {
+                std::istringstream stream(line);
+                std::string key;
+                uint64_t seed;
+                if (stream >> key >> seed)
+                {
+                    auto& seeds = m_Seeds[key];
+                    if (std::find(seeds.begin(), seeds.end(), seed) == seeds.end())
+                    {
+                        seeds.push_back(seed);
+                    }
+                }
+            }
+            return true;
+        }
+
+        const std::vector<uint64_t>* Find(std::string_view key) const
+        {
+            auto it = m_Seeds.find(key);
+            return it != m_Seeds.end() ? &it->second : nullptr;
+        }
+
+        void Add(const std::string& key, uint64_t seed)
+        {
+            auto seeds = Find(key);
+            if (m_Path.empty() || (seeds && std::find(seeds->begin(), seeds->end(), seed) != seeds->end()))
+            {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            std::ofstream file(m_Path, std::ios::app);
+            file << key << ' ' << seed << '\n';
+        }
+    };
+} // namespace EVA::TEST
@@ -0,0 +1,56 @@
+#pragma once
+#include <fstream>
+#include <set>
+#include <string>
+
+namespace EVA::TEST
+{
+    // The tests that failed in previous runs, keyed by "category::name". Stored as text, one key per line.
+    class Failures
+    {
+        std::set<std::string> m_Keys;
+
+      public:
+        bool Load(const std::string& path)
+        {
+            std::ifstream file(path);
+            if (!file)
+            {
+                return false;
+            }
+            std::string key;
+            while (std::getline(file, key))
+            {
+                if (!key.empty())
+                {
+                    m_Keys.insert(key);
+                }
+            }
+            return true;
+        }
+
+        bool Save(const std::string& path) const
+        {
+            std::ofstream file(path, std::ios::trunc);
+            for (const auto& key : m_Keys)
+            {
+                file << key << '\n';
+            }
+            return static_cast<bool>(file);
+        }
+
+        bool Contains(const std::string& key) const { return m_Keys.count(key) != 0; }
+
+        void Set(const std::string& key, bool failed)
+        {
+            if (failed)
+            {
+                m_Keys.insert(key);
+            }
+            else
+            {
+                m_Keys.erase(key);
+            }
+        }
+    };
+} // namespace EVA::TEST
@@ -0,0 +1,150 @@
+#pragma once
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace EVA::TEST
+{
+    // Matches "*" against any sequence and "?" against any single character
+    inline bool Glob(const char* pattern, const char* text)
+    {
+        const char* star     = nullptr;
+        const char* starText = nullptr;
+        while (*text)
+        {
+            if (*pattern == '*')
+            {
+                star     = pattern++;
+                starText = text;
+            }
+            else if (*pattern == '?' || *pattern == *text)
+            {
+                pattern++;
+                text++;
+            }
+            else if (star)
+            {
+                pattern = star + 1;
+                text    = ++starText;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        while (*pattern == '*')
+        {
+            pattern++;
+        }
+        return *pattern == '\0';
+    }
+
+    // A gtest style filter: "POSITIVE:POSITIVE-NEGATIVE:NEGATIVE". A key is selected if it matches any of the positive
+    // patterns, or there are none, and none of the negative ones.
+    class Filter
+    {
+        std::vector<std::string> m_Positive;
+        std::vector<std::string> m_Negative;
+
+        // Patterns are separated by a single ':', a "::" belongs to the pattern
+        static void Split(const std::string& patterns, std::vector<std::string>& out)
+        {
+            std::string pattern;
+            for (size_t i = 0; i < patterns.size(); i++)
+            {
+                if (patterns[i] != ':')
+                {
+                    pattern += patterns[i];
+                }
+                else if (i + 1 < patterns.size() && patterns[i + 1] == ':')
+                {
+                    pattern += "::";
+                    i++;
+                }
+                else if (!pattern.empty())
+                {
+                    out.push_back(std::move(pattern));
+                    pattern.clear();
+                }
+            }
+            if (!pattern.empty())
+            {
+                out.push_back(std::move(pattern));
+            }
+        }
+
+        bool Excluded(const std::string& key) const
+        {
+            for (const auto& pattern : m_Negative)
+            {
+                if (Glob(pattern.c_str(), key.c_str()))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+      public:
+        explicit Filter(const std::string& filter)
+        {
+            size_t dash = filter.find('-');
+            Split(filter.substr(0, dash), m_Positive);
+            if (dash != std::string::npos)
+            {
+                Split(filter.substr(dash + 1), m_Negative);
+            }
+        }
+
+        bool Matches(const std::string& key) const
+        {
+            if (Excluded(key))
+            {
+                return false;
+            }
+            if (m_Positive.empty())
+            {
+                return true;
+            }
+            for (const auto& pattern : m_Positive)
+            {
+                if (Glob(pattern.c_str(), key.c_str()))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Calls select(i) for every matching key in the sorted keys. Each positive pattern only looks at the keys that
+        // start with its literal prefix, so "Category::*" costs a binary search plus the size of the category. A key
+        // matched by several patterns is selected several times.
+        template <typename F> void Select(const std::vector<std::string>& keys, F&& select) const
+        {
+            if (m_Positive.empty())
+            {
+                for (size_t i = 0; i < keys.size(); i++)
+                {
+                    if (!Excluded(keys[i]))
+                    {
+                        select(i);
+                    }
+                }
+                return;
+            }
+
+            for (const auto& pattern : m_Positive)
+            {
+                std::string prefix = pattern.substr(0, pattern.find_first_of("*?"));
+                for (auto it = std::lower_bound(keys.begin(), keys.end(), prefix); it != keys.end() && it->compare(0, prefix.size(), prefix) == 0;
+                     ++it)
+                {
+                    if (Glob(pattern.c_str(), it->c_str()) && !Excluded(*it))
+                    {
+                        select(static_cast<size_t>(it - keys.begin()));
+                    }
+                }
+            }
+        }
+    };
+} // namespace EVA::TEST
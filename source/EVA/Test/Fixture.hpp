@@ -0,0 +1,42 @@
+#pragma once
+#include "Shared.hpp"
+#include "Test.hpp"
+
+namespace EVA::TEST
+{
+    // Base of the TEST_F fixtures. Every test gets a fresh fixture, with SetUp called before and TearDown after its body.
+    // The body is skipped if SetUp failed. State that is expensive to build and only read belongs in a static Shared member.
+    class Fixture
+    {
+      public:
+        virtual ~Fixture() = default;
+
+        virtual void SetUp() {}
+        virtual void TearDown() {}
+
+      protected:
+        static void Fail() { FunctionMap::FailCurrent(); }
+    };
+
+    template <typename T> void RunFixture()
+    {
+        T fixture;
+        fixture.SetUp();
+        if (!FunctionMap::CurrentRunFailed())
+        {
+            fixture.Body();
+        }
+        fixture.TearDown();
+    }
+} // namespace EVA::TEST
+
+#define TEST_F(FIXTURE, NAME)                                                                                                              \
+    struct TestF_##FIXTURE##NAME : FIXTURE                                                                                                 \
+    {                                                                                                                                      \
+        void Body();                                                                                                                       \
+        static void Run() { EVA::TEST::RunFixture<TestF_##FIXTURE##NAME>(); }                                                              \
+        inline static EVA::TEST::FunctionInfo s_Info = { &Run, #NAME, #FIXTURE, __FILE__ };                                                \
+        inline static void Fail() { EVA::TEST::FunctionMap::Fail(s_Info); }                                                                \
+    };                                                                                                                                     \
+    inline static EVA::TEST::Registrar testF_##FIXTURE##NAME(TestF_##FIXTURE##NAME::s_Info);                                               \
+    void TestF_##FIXTURE##NAME::Body()
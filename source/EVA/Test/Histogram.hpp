@@ -0,0 +1,143 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace EVA::TEST
+{
+    // Durations in nanoseconds, counted in log-linear buckets as in HdrHistogram. Every power of two is split into 32
+    // buckets, so a percentile is within about 3% of the exact value, whatever the range of the durations.
+    class Histogram
+    {
+        static constexpr int s_SubBits       = 5;
+        static constexpr uint64_t s_SubCount = uint64_t(1) << s_SubBits;
+
+        std::vector<uint64_t> m_Counts;
+        uint64_t m_Count = 0;
+        uint64_t m_Min   = std::numeric_limits<uint64_t>::max();
+        uint64_t m_Max   = 0;
+        double m_Mean    = 0;
+        double m_M2      = 0;
+
+        static size_t Index(uint64_t value)
+        {
+            if (value < 2 * s_SubCount)
+            {
+                return static_cast<size_t>(value);
+            }
+            int exponent = 63;
+            while (!(value >> exponent))
+            {
+                exponent--;
+            }
+            int shift = exponent - s_SubBits;
+            return static_cast<size_t>(shift * s_SubCount + (value >> shift));
+        }
+
+        // The largest value that falls into the bucket
+        static uint64_t Highest(size_t index)
+        {
+            if (index < 2 * s_SubCount)
+            {
+                return index;
+            }
+            uint64_t shift = index / s_SubCount - 1;
+            uint64_t top   = index - shift * s_SubCount;
+            return ((top + 1) << shift) - 1;
+        }
+
+      public:
+        void Record(uint64_t ns)
+        {
+            size_t index = Index(ns);
+            if (index >= m_Counts.size())
+            {
+                m_Counts.resize(index + 1, 0);
+            }
+            m_Counts[index]++;
+            m_Count++;
+
+            // Welford's update, which stays accurate for durations that vary little around a large mean
+            double delta = static_cast<double>(ns) - m_Mean;
+            m_Mean += delta / m_Count;
+            m_M2 += delta * (static_cast<double>(ns) - m_Mean);
+            m_Min = std::min(m_Min, ns);
+            m_Max = std::max(m_Max, ns);
+        }
+
+        uint64_t Count() const { return m_Count; }
+        uint64_t Min() const { return m_Count ? m_Min : 0; }
+        uint64_t Max() const { return m_Max; }
+        double Mean() const { return m_Mean; }
+        double Stddev() const { return m_Count > 1 ? std::sqrt(m_M2 / (m_Count - 1)) : 0; }
+
+        // The value that the given fraction of the durations do not exceed, such as 0.999 for p99.9
+        uint64_t Percentile(double fraction) const
+        {
+            uint64_t rank  = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(fraction * m_Count)), 1);
+            uint64_t count = 0;
+            for (size_t i = 0; i < m_Counts.size(); i++)
+            {
+                count += m_Counts[i];
+                if (count >= rank)
+                {
+                    return std::clamp(Highest(i), Min(), m_Max);
+                }
+            }
+            return m_Max;
+        }
+
+        // As u64 count, min and max, f64 mean and sum of squared deviations, u64 number of used buckets, and a u32 index and
+        // u64 count for each used bucket
+        void Encode(std::string& payload) const
+        {
+            auto put = [&](auto value) { payload.append(reinterpret_cast<const char*>(&value), sizeof(value)); };
+            put(m_Count);
+            put(m_Min);
+            put(m_Max);
+            put(m_Mean);
+            put(m_M2);
+            put(static_cast<uint64_t>(std::count_if(m_Counts.begin(), m_Counts.end(), [](uint64_t count) { return count != 0; })));
+            for (size_t i = 0; i < m_Counts.size(); i++)
+            {
+                if (m_Counts[i] != 0)
+                {
+                    put(static_cast<uint32_t>(i));
+                    put(m_Counts[i]);
+                }
+            }
+        }
+
+        void Decode(const std::string& payload, size_t& offset)
+        {
+            auto get = [&](auto& value) {
+                std::memcpy(&value, &payload[offset], sizeof(value));
+                offset += sizeof(value);
+            };
+            uint64_t buckets;
+            get(m_Count);
+            get(m_Min);
+            get(m_Max);
+            get(m_Mean);
+            get(m_M2);
+            get(buckets);
+            m_Counts.clear();
+            for (uint64_t i = 0; i < buckets; i++)
+            {
+                uint32_t index;
+                uint64_t count;
+                get(index);
+                get(count);
+                if (index >= m_Counts.size())
+                {
+                    m_Counts.resize(index + 1, 0);
+                }
+                m_Counts[index] = count;
+            }
+        }
+    };
+} // namespace EVA::TEST
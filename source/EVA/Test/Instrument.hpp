@@ -0,0 +1,128 @@
+#pragma once
+#include <cstdint>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #define EVA_TEST_HAS_RUSAGE 1
+    #include <sys/resource.h>
+#else
+    #define EVA_TEST_HAS_RUSAGE 0
+#endif
+
+#if defined(__GLIBC__) || defined(__APPLE__)
+    #define EVA_TEST_HAS_BACKTRACE 1
+    #include <execinfo.h>
+#else
+    #define EVA_TEST_HAS_BACKTRACE 0
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define EVA_TEST_ALWAYS_INLINE __attribute__((always_inline)) inline
+    #define EVA_TEST_NOINLINE      __attribute__((noinline))
+#elif defined(_MSC_VER)
+    #define EVA_TEST_ALWAYS_INLINE __forceinline
+    #define EVA_TEST_NOINLINE      __declspec(noinline)
+#else
+    #define EVA_TEST_ALWAYS_INLINE inline
+    #define EVA_TEST_NOINLINE
+#endif
+
+namespace EVA::TEST
+{
+    // The heap allocations made by the calling thread. Counted by the operator new replacements in Test.cpp, unless the
+    // library is built with EVA_TEST_NO_ALLOCATION_HOOK.
+    class Allocations
+    {
+      public:
+        static constexpr int s_MaxFrames = 32;
+
+        // The frames of the hook at the top of a trace: Capture and the operator new that called it, as the hook is
+        // inlined into operator new and Capture never is
+        static constexpr int s_HookFrames = 2;
+
+      private:
+        inline static thread_local uint64_t s_Count   = 0;
+        inline static thread_local uint64_t s_Bytes   = 0;
+        inline static thread_local uint64_t s_Trap    = 0;
+        inline static thread_local uint64_t s_TraceAt = 0;
+        inline static thread_local int s_TraceSize    = 0;
+        inline static thread_local void* s_Trace[s_MaxFrames];
+
+        EVA_TEST_NOINLINE static void Capture()
+        {
+#if EVA_TEST_HAS_BACKTRACE
+            s_TraceSize = backtrace(s_Trace, s_MaxFrames);
+            s_TraceAt   = s_Count;
+#endif
+        }
+
+      public:
+        EVA_TEST_ALWAYS_INLINE static void Record(size_t bytes)
+        {
+            s_Count++;
+            s_Bytes += bytes;
+            if (s_Count == s_Trap)
+            {
+                Capture();
+            }
+        }
+
+        static uint64_t Count() { return s_Count; }
+        static uint64_t Bytes() { return s_Bytes; }
+
+        // Captures a backtrace of the allocation that brings the count up to the given value, 0 for none. Returns the
+        // previous trap, for nested scopes to restore.
+        static uint64_t Trap(uint64_t count)
+        {
+            uint64_t previous = s_Trap;
+            s_Trap            = count;
+            return previous;
+        }
+
+        // The frames captured for the allocation with the given count, if any
+        static int Trace(uint64_t count, void* const*& frames)
+        {
+            frames = s_Trace;
+            return s_TraceAt == count ? s_TraceSize : 0;
+        }
+    };
+
+    // Resources used by the calling thread. The CPU time is per thread where the platform supports it, and for the whole
+    // process otherwise. The peak resident set size is always that of the process, in KiB.
+    struct Usage
+    {
+        uint64_t userQs      = 0;
+        uint64_t systemQs    = 0;
+        uint64_t allocations = 0;
+        uint64_t bytes       = 0;
+        uint64_t peakRss     = 0;
+
+        static Usage Sample()
+        {
+            Usage usage;
+            usage.allocations = Allocations::Count();
+            usage.bytes       = Allocations::Bytes();
+#if EVA_TEST_HAS_RUSAGE
+            rusage self{};
+            getrusage(RUSAGE_SELF, &self);
+    #if defined(__APPLE__)
+            usage.peakRss = static_cast<uint64_t>(self.ru_maxrss) / 1024;
+    #else
+            usage.peakRss = static_cast<uint64_t>(self.ru_maxrss);
+    #endif
+    #if defined(RUSAGE_THREAD)
+            getrusage(RUSAGE_THREAD, &self);
+    #endif
+            usage.userQs   = static_cast<uint64_t>(self.ru_utime.tv_sec) * 1000000 + self.ru_utime.tv_usec;
+            usage.systemQs = static_cast<uint64_t>(self.ru_stime.tv_sec) * 1000000 + self.ru_stime.tv_usec;
+#endif
+            return usage;
+        }
+
+        // What was used since the start sample was taken
+        Usage Since(const Usage& start) const
+        {
+            return Usage{ userQs - start.userQs, systemQs - start.systemQs, allocations - start.allocations, bytes - start.bytes,
+                          peakRss - start.peakRss };
+        }
+    };
+} // namespace EVA::TEST
@@ -0,0 +1,170 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+#include "Test.hpp"
+
+namespace EVA::TEST
+{
+    // A name built at compile time, for the instances of parameterized and typed tests
+    template <size_t N> struct FixedString
+    {
+        char data[N + 1] = {};
+
+        constexpr std::string_view View() const { return { data, N }; }
+    };
+
+    constexpr size_t CountDigits(size_t value) { return value < 10 ? 1 : 1 + CountDigits(value / 10); }
+
+    constexpr size_t CountNonSpace(std::string_view text)
+    {
+        size_t count = 0;
+        for (char c : text)
+        {
+            count += c != ' ';
+        }
+        return count;
+    }
+
+    // Item i of a comma separated list without its surrounding spaces. Commas inside brackets belong to the item.
+    constexpr std::string_view ListItem(std::string_view list, size_t index)
+    {
+        size_t begin = 0;
+        int depth    = 0;
+        for (size_t i = 0; i <= list.size(); i++)
+        {
+            if (i == list.size() || (list[i] == ',' && depth == 0))
+            {
+                if (index-- == 0)
+                {
+                    std::string_view item = list.substr(begin, i - begin);
+                    while (!item.empty() && item.front() == ' ')
+                    {
+                        item.remove_prefix(1);
+                    }
+                    while (!item.empty() && item.back() == ' ')
+                    {
+                        item.remove_suffix(1);
+                    }
+                    return item;
+                }
+                begin = i + 1;
+            }
+            else if (list[i] == '<' || list[i] == '(' || list[i] == '[' || list[i] == '{')
+            {
+                depth++;
+            }
+            else if (list[i] == '>' || list[i] == ')' || list[i] == ']' || list[i] == '}')
+            {
+                depth--;
+            }
+        }
+        return {};
+    }
+
+    // "NAME/I"
+    template <typename Names, size_t I> constexpr auto IndexedName()
+    {
+        FixedString<Names::s_Name.size() + 1 + CountDigits(I)> name;
+        size_t size = 0;
+        for (char c : Names::s_Name)
+        {
+            name.data[size++] = c;
+        }
+        name.data[size++] = '/';
+        size_t value      = I;
+        for (size_t i = CountDigits(I); i-- > 0; value /= 10)
+        {
+            name.data[size + i] = static_cast<char>('0' + value % 10);
+        }
+        return name;
+    }
+
+    // "NAME<TYPE>", with the type as it was spelled in the list but without spaces, as the timings and baseline files
+    // separate their fields by whitespace
+    template <typename Names, size_t I> constexpr auto TypedName()
+    {
+        constexpr std::string_view type = ListItem(Names::s_Types, I);
+        FixedString<Names::s_Name.size() + CountNonSpace(type) + 2> name;
+        size_t size = 0;
+        for (char c : Names::s_Name)
+        {
+            name.data[size++] = c;
+        }
+        name.data[size++] = '<';
+        for (char c : type)
+        {
+            if (c != ' ')
+            {
+                name.data[size++] = c;
+            }
+        }
+        name.data[size] = '>';
+        return name;
+    }
+
+    template <typename T, typename... Rest> constexpr std::array<T, 1 + sizeof...(Rest)> Values(T first, Rest... rest)
+    {
+        return { first, static_cast<T>(rest)... };
+    }
+
+    // From, From + Step, ... up to but not including To
+    template <typename T, T From, T To, T Step = 1> constexpr auto Sequence()
+    {
+        std::array<T, (To - From + Step - 1) / Step> values{};
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            values[i] = static_cast<T>(From + i * Step);
+        }
+        return values;
+    }
+
+    // Registers the instances 0 to Count - 1 of a parameterized or typed test, in order
+    template <template <size_t> class Instance, size_t Count> struct Instances
+    {
+        template <size_t... I> static void Add(std::index_sequence<I...>) { (FunctionMap::Add(Instance<I>::s_Info), ...); }
+
+        Instances() { Add(std::make_index_sequence<Count>()); }
+    };
+} // namespace EVA::TEST
+
+// One test per value of a constexpr array, such as EVA::TEST::Values(16, 256, 4096). The body reads its value with GetParam().
+#define TEST_P(CATEGORY, NAME, ...)                                                                                                        \
+    struct TestNames_##CATEGORY##NAME                                                                                                      \
+    {                                                                                                                                      \
+        static constexpr std::string_view s_Name = #NAME;                                                                                  \
+        static constexpr auto s_Values           = __VA_ARGS__;                                                                            \
+    };                                                                                                                                     \
+    template <size_t I> struct TestP_##CATEGORY##NAME                                                                                      \
+    {                                                                                                                                      \
+        static void Run();                                                                                                                 \
+        static constexpr const auto& GetParam() { return TestNames_##CATEGORY##NAME::s_Values[I]; }                                        \
+        inline static constexpr auto s_Name          = EVA::TEST::IndexedName<TestNames_##CATEGORY##NAME, I>();                            \
+        inline static EVA::TEST::FunctionInfo s_Info = { &Run, s_Name.View(), #CATEGORY, __FILE__ };                                       \
+        inline static void Fail() { EVA::TEST::FunctionMap::Fail(s_Info); }                                                                \
+    };                                                                                                                                     \
+    inline static EVA::TEST::Instances<TestP_##CATEGORY##NAME, TestNames_##CATEGORY##NAME::s_Values.size()> testP_##CATEGORY##NAME;        \
+    template <size_t I> void TestP_##CATEGORY##NAME<I>::Run()
+
+// One test per type in the list. The body refers to its type as TypeParam.
+#define TYPED_TEST(CATEGORY, NAME, ...)                                                                                                    \
+    struct TypedNames_##CATEGORY##NAME                                                                                                     \
+    {                                                                                                                                      \
+        static constexpr std::string_view s_Name  = #NAME;                                                                                 \
+        static constexpr std::string_view s_Types = #__VA_ARGS__;                                                                          \
+        using Types                               = std::tuple<__VA_ARGS__>;                                                               \
+    };                                                                                                                                     \
+    template <size_t I> struct TypedTest_##CATEGORY##NAME                                                                                  \
+    {                                                                                                                                      \
+        using TypeParam = std::tuple_element_t<I, TypedNames_##CATEGORY##NAME::Types>;                                                     \
+        static void Run();                                                                                                                 \
+        inline static constexpr auto s_Name          = EVA::TEST::TypedName<TypedNames_##CATEGORY##NAME, I>();                             \
+        inline static EVA::TEST::FunctionInfo s_Info = { &Run, s_Name.View(), #CATEGORY, __FILE__ };                                       \
+        inline static void Fail() { EVA::TEST::FunctionMap::Fail(s_Info); }                                                                \
+    };                                                                                                                                     \
+    inline static EVA::TEST::Instances<TypedTest_##CATEGORY##NAME, std::tuple_size_v<TypedNames_##CATEGORY##NAME::Types>>                  \
+        typedTest_##CATEGORY##NAME;                                                                                                        \
+    template <size_t I> void TypedTest_##CATEGORY##NAME<I>::Run()
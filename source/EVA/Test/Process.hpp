@@ -0,0 +1,323 @@
+#pragma once
+#if defined(__unix__) || defined(__APPLE__)
+    #define EVA_TEST_HAS_FORK 1
+#else
+    #define EVA_TEST_HAS_FORK 0
+#endif
+
+#if EVA_TEST_HAS_FORK
+    #include <algorithm>
+    #include <cerrno>
+    #include <chrono>
+    #include <csignal>
+    #include <cstdint>
+    #include <cstring>
+    #include <functional>
+    #include <iostream>
+    #include <string>
+    #include <vector>
+
+    #include <poll.h>
+    #include <sys/wait.h>
+    #include <unistd.h>
+
+namespace EVA::TEST
+{
+    // Runs shards of tasks in forked worker processes. A worker reports a start frame before and an end frame after every
+    // task over a pipe:
+    //   'S' u32 index
+    //   'E' u32 index, u32 length, payload
+    // If a worker dies or overruns the timeout of the task it had started, that task is reported as crashed and a new
+    // worker is forked for the rest of its shard. Tasks without a timeout, 0, may run for as long as they like.
+    class ProcessPool
+    {
+      public:
+        using Task   = std::function<std::string(size_t index)>;
+        using Result = std::function<void(size_t index, bool crashed, const std::string& payload)>;
+
+      private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Worker
+        {
+            pid_t pid;
+            int fd;
+            size_t shard;
+            size_t position;
+            bool running;
+            bool timedOut;
+            size_t timeout;
+            Clock::time_point start;
+            std::string buffer;
+        };
+
+        std::vector<std::vector<size_t>> m_Shards;
+        std::vector<Worker> m_Workers;
+        std::vector<size_t> m_Timeouts;
+        bool m_Stopped = false;
+        Task m_Task;
+        Result m_Result;
+
+        static void Write(int fd, const void* data, size_t size)
+        {
+            auto bytes = static_cast<const char*>(data);
+            while (size > 0)
+            {
+                ssize_t written = write(fd, bytes, size);
+                if (written < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    _exit(1);
+                }
+                bytes += written;
+                size -= written;
+            }
+        }
+
+        static void WriteFrame(int fd, char type, uint32_t index, const std::string* payload)
+        {
+            char header[9];
+            header[0] = type;
+            std::memcpy(header + 1, &index, sizeof(index));
+            if (!payload)
+            {
+                Write(fd, header, 5);
+                return;
+            }
+            uint32_t length = static_cast<uint32_t>(payload->size());
+            std::memcpy(header + 5, &length, sizeof(length));
+            Write(fd, header, 9);
+            Write(fd, payload->data(), payload->size());
+        }
+
+        void Spawn(size_t shard, size_t position)
+        {
+            const auto& tasks = m_Shards[shard];
+
+            int fds[2];
+            pid_t pid = -1;
+            std::cout.flush();
+            if (pipe(fds) == 0)
+            {
+                pid = fork();
+                if (pid < 0)
+                {
+                    close(fds[0]);
+                    close(fds[1]);
+                }
+            }
+
+            if (pid == 0)
+            {
+                close(fds[0]);
+                for (size_t i = position; i < tasks.size(); i++)
+                {
+                    uint32_t index = static_cast<uint32_t>(tasks[i]);
+                    WriteFrame(fds[1], 'S', index, nullptr);
+                    std::string payload = m_Task(tasks[i]);
+                    WriteFrame(fds[1], 'E', index, &payload);
+                }
+                std::cout.flush();
+                _exit(0);
+            }
+
+            if (pid < 0)
+            {
+                for (size_t i = position; i < tasks.size(); i++)
+                {
+                    m_Result(tasks[i], true, "Could not start a worker process");
+                }
+                return;
+            }
+
+            close(fds[1]);
+            m_Workers.push_back(Worker{ pid, fds[0], shard, position, false, false, 0, Clock::now(), {} });
+        }
+
+        void Parse(Worker& worker)
+        {
+            size_t offset = 0;
+            while (worker.buffer.size() - offset >= 5)
+            {
+                const char* frame = worker.buffer.data() + offset;
+                if (frame[0] == 'S')
+                {
+                    uint32_t index;
+                    std::memcpy(&index, frame + 1, sizeof(index));
+                    worker.running = true;
+                    worker.timeout = index < m_Timeouts.size() ? m_Timeouts[index] : 0;
+                    worker.start   = Clock::now();
+                    offset += 5;
+                    continue;
+                }
+
+                if (worker.buffer.size() - offset < 9)
+                {
+                    break;
+                }
+                uint32_t index, length;
+                std::memcpy(&index, frame + 1, sizeof(index));
+                std::memcpy(&length, frame + 5, sizeof(length));
+                if (worker.buffer.size() - offset - 9 < length)
+                {
+                    break;
+                }
+                worker.running = false;
+                worker.position++;
+                m_Result(index, false, std::string(frame + 9, length));
+                offset += 9 + length;
+            }
+            worker.buffer.erase(0, offset);
+        }
+
+        void Finish(Worker worker)
+        {
+            close(worker.fd);
+
+            int status = 0;
+            while (waitpid(worker.pid, &status, 0) < 0 && errno == EINTR)
+            {
+            }
+
+            const auto& tasks = m_Shards[worker.shard];
+            if (m_Stopped || worker.position >= tasks.size())
+            {
+                return;
+            }
+
+            // A worker that died between two tasks blames the next one, so that the shard always makes progress
+            std::string description;
+            if (worker.timedOut)
+            {
+                description = "Timed out after " + std::to_string(worker.timeout) + " ms";
+            }
+            else if (WIFSIGNALED(status))
+            {
+                description = "Crashed with signal " + std::to_string(WTERMSIG(status)) + " (" + strsignal(WTERMSIG(status)) + ")";
+            }
+            else
+            {
+                description = "Exited with code " + std::to_string(WEXITSTATUS(status));
+            }
+            m_Result(tasks[worker.position], true, description);
+
+            if (worker.position + 1 < tasks.size())
+            {
+                Spawn(worker.shard, worker.position + 1);
+            }
+        }
+
+        int PollTimeout(Clock::time_point now) const
+        {
+            long long timeout = -1;
+            for (const auto& worker : m_Workers)
+            {
+                if (worker.running && !worker.timedOut && worker.timeout != 0)
+                {
+                    auto elapsed        = std::chrono::duration_cast<std::chrono::milliseconds>(now - worker.start).count();
+                    long long remaining = elapsed >= static_cast<long long>(worker.timeout) ? 0 : worker.timeout - elapsed;
+                    timeout             = timeout < 0 ? remaining : std::min(timeout, remaining);
+                }
+            }
+            return timeout < 0 ? -1 : static_cast<int>(timeout) + 1;
+        }
+
+      public:
+        // The timeouts are in milliseconds, by task index
+        ProcessPool(std::vector<std::vector<size_t>> shards, std::vector<size_t> timeouts, Task task, Result result)
+            : m_Shards(std::move(shards)), m_Timeouts(std::move(timeouts)), m_Task(std::move(task)), m_Result(std::move(result))
+        {
+            for (size_t i = 0; i < m_Shards.size(); i++)
+            {
+                if (!m_Shards[i].empty())
+                {
+                    Spawn(i, 0);
+                }
+            }
+        }
+
+        ~ProcessPool()
+        {
+            while (Pump())
+            {
+            }
+        }
+
+        ProcessPool(const ProcessPool&) = delete;
+        ProcessPool& operator=(const ProcessPool&) = delete;
+
+        // Kills the workers. The tasks they had not finished are not reported.
+        void Stop()
+        {
+            if (m_Stopped)
+            {
+                return;
+            }
+            m_Stopped = true;
+            for (const auto& worker : m_Workers)
+            {
+                kill(worker.pid, SIGKILL);
+            }
+        }
+
+        // Waits for the workers and dispatches their results. Returns false once every shard is done.
+        bool Pump()
+        {
+            if (m_Workers.empty())
+            {
+                return false;
+            }
+
+            std::vector<pollfd> fds;
+            for (const auto& worker : m_Workers)
+            {
+                fds.push_back(pollfd{ worker.fd, POLLIN, 0 });
+            }
+            if (poll(fds.data(), fds.size(), PollTimeout(Clock::now())) < 0 && errno != EINTR)
+            {
+                return true;
+            }
+
+            auto now = Clock::now();
+            std::vector<size_t> finished;
+            for (size_t i = 0; i < m_Workers.size(); i++)
+            {
+                auto& worker = m_Workers[i];
+                if (worker.running && !worker.timedOut && worker.timeout != 0 && now - worker.start >= std::chrono::milliseconds(worker.timeout))
+                {
+                    kill(worker.pid, SIGKILL);
+                    worker.timedOut = true;
+                }
+
+                if (fds[i].revents == 0)
+                {
+                    continue;
+                }
+
+                char buffer[65536];
+                ssize_t size = read(worker.fd, buffer, sizeof(buffer));
+                if (size > 0)
+                {
+                    worker.buffer.append(buffer, size);
+                    Parse(worker);
+                }
+                else if (size == 0 || (errno != EINTR && errno != EAGAIN))
+                {
+                    finished.push_back(i);
+                }
+            }
+
+            for (auto it = finished.rbegin(); it != finished.rend(); ++it)
+            {
+                Worker worker = std::move(m_Workers[*it]);
+                m_Workers.erase(m_Workers.begin() + *it);
+                Finish(std::move(worker));
+            }
+            return true;
+        }
+    };
+} // namespace EVA::TEST
+#endif
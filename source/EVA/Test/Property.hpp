@@ -0,0 +1,461 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Test.hpp"
+
+namespace EVA::TEST
+{
+    // xoshiro256**, seeded through SplitMix64
+    class Random
+    {
+        uint64_t m_State[4];
+
+        static constexpr uint64_t Rotate(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+      public:
+        static constexpr uint64_t SplitMix(uint64_t& x)
+        {
+            uint64_t z = (x += 0x9e3779b97f4a7c15);
+            z          = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+            z          = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+            return z ^ (z >> 31);
+        }
+
+        explicit Random(uint64_t seed)
+        {
+            for (auto& state : m_State)
+            {
+                state = SplitMix(seed);
+            }
+        }
+
+        uint64_t Next()
+        {
+            uint64_t result = Rotate(m_State[1] * 5, 7) * 9;
+            uint64_t t      = m_State[1] << 17;
+            m_State[2] ^= m_State[0];
+            m_State[3] ^= m_State[1];
+            m_State[1] ^= m_State[2];
+            m_State[0] ^= m_State[3];
+            m_State[2] ^= t;
+            m_State[3] = Rotate(m_State[3], 45);
+            return result;
+        }
+
+        // Uniform in [0, bound]
+        uint64_t Below(uint64_t bound)
+        {
+            uint64_t mask = bound;
+            for (int shift = 1; shift < 64; shift *= 2)
+            {
+                mask |= mask >> shift;
+            }
+            uint64_t value;
+            do
+            {
+                value = Next() & mask;
+            } while (value > bound);
+            return value;
+        }
+
+        // Uniform in [0, 1)
+        double Unit() { return static_cast<double>(Next() >> 11) * 0x1.0p-53; }
+    };
+
+    // The generators of a PROPERTY fill in a value of their Type from a Random, and shrink a failing value in place: they
+    // try simpler values, keep the ones for which fails() still holds, and return whether any was kept. Generating into the
+    // previous case's value lets vectors keep their capacity, so that a case does not allocate.
+
+    // Integers in [min, max]. One case in 8 is an edge: min, max or the value closest to 0, which is what shrinking aims for.
+    template <typename T> struct Int
+    {
+        static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>, "Int takes an integer type, use Bool for bool");
+        using Type     = T;
+        using Unsigned = std::make_unsigned_t<T>;
+
+        T min;
+        T max;
+
+        constexpr Int() : min(std::numeric_limits<T>::min()), max(std::numeric_limits<T>::max()) {}
+        constexpr Int(T min, T max) : min(min), max(max) {}
+
+        constexpr T Target() const { return min > 0 ? min : max < 0 ? max : 0; }
+
+        void Generate(Random& random, T& value) const
+        {
+            uint64_t bits = random.Next();
+            if ((bits & 7) == 0)
+            {
+                T edges[] = { min, max, Target() };
+                value     = edges[(bits >> 3) % 3];
+                return;
+            }
+            Unsigned range = static_cast<Unsigned>(static_cast<Unsigned>(max) - static_cast<Unsigned>(min));
+            value          = static_cast<T>(static_cast<Unsigned>(static_cast<Unsigned>(min) + random.Below(range)));
+        }
+
+        template <typename Fails> bool Shrink(T& value, const Fails& fails) const
+        {
+            T original = value;
+            T target   = Target();
+            if (value == target)
+            {
+                return false;
+            }
+            value = target;
+            if (fails())
+            {
+                return true;
+            }
+
+            // The target passes, so bisects towards the closest value that still fails
+            T passing = target;
+            T failing = original;
+            for (;;)
+            {
+                bool up           = failing > passing;
+                Unsigned distance = static_cast<Unsigned>(up ? static_cast<Unsigned>(failing) - static_cast<Unsigned>(passing)
+                                                             : static_cast<Unsigned>(passing) - static_cast<Unsigned>(failing));
+                if (distance <= 1)
+                {
+                    break;
+                }
+                Unsigned half = static_cast<Unsigned>(distance / 2);
+                value = static_cast<T>(up ? static_cast<Unsigned>(static_cast<Unsigned>(passing) + half)
+                                          : static_cast<Unsigned>(static_cast<Unsigned>(passing) - half));
+                (fails() ? failing : passing) = value;
+            }
+            value = failing;
+            return failing != original;
+        }
+    };
+
+    template <typename T> Int(T, T) -> Int<T>;
+
+    // Floating point values in [min, max]. Shrinks towards the value closest to 0, then whole numbers.
+    template <typename T> struct Real
+    {
+        static_assert(std::is_floating_point_v<T>, "Real takes a floating point type");
+        using Type = T;
+
+        T min;
+        T max;
+
+        constexpr Real(T min, T max) : min(min), max(max) {}
+
+        constexpr T Target() const { return min > 0 ? min : max < 0 ? max : 0; }
+
+        void Generate(Random& random, T& value) const
+        {
+            uint64_t bits = random.Next();
+            if ((bits & 7) == 0)
+            {
+                T edges[] = { min, max, Target() };
+                value     = edges[(bits >> 3) % 3];
+                return;
+            }
+            value = std::min(max, static_cast<T>(min + (max - min) * random.Unit()));
+        }
+
+        template <typename Fails> bool Shrink(T& value, const Fails& fails) const
+        {
+            T original = value;
+            for (T candidate : { Target(), std::trunc(value) })
+            {
+                if (candidate != value && candidate >= min && candidate <= max)
+                {
+                    value = candidate;
+                    if (fails())
+                    {
+                        return true;
+                    }
+                    value = original;
+                }
+            }
+
+            T passing = Target();
+            T failing = original;
+            for (int i = 0; i < 64; i++)
+            {
+                value = passing + (failing - passing) / 2;
+                if (value == passing || value == failing)
+                {
+                    break;
+                }
+                (fails() ? failing : passing) = value;
+            }
+            value = failing;
+            return failing != original;
+        }
+    };
+
+    template <typename T> Real(T, T) -> Real<T>;
+
+    struct Bool
+    {
+        using Type = bool;
+
+        void Generate(Random& random, bool& value) const { value = random.Next() & 1; }
+
+        template <typename Fails> bool Shrink(bool& value, const Fails& fails) const
+        {
+            if (!value)
+            {
+                return false;
+            }
+            value = false;
+            if (fails())
+            {
+                return true;
+            }
+            value = true;
+            return false;
+        }
+    };
+
+    // Up to maxSize elements from another generator. Shrinks by removing runs of elements, from half of them down to
+    // single ones, and then by shrinking the remaining elements.
+    template <typename Element> struct Vector
+    {
+        using Type = std::vector<typename Element::Type>;
+
+        Element element;
+        size_t maxSize;
+
+        constexpr explicit Vector(Element element, size_t maxSize = 64) : element(element), maxSize(maxSize) {}
+
+        void Generate(Random& random, Type& value) const
+        {
+            value.resize(random.Below(maxSize));
+            for (auto& item : value)
+            {
+                element.Generate(random, item);
+            }
+        }
+
+        template <typename Fails> bool Shrink(Type& value, const Fails& fails) const
+        {
+            bool shrunk = false;
+            for (size_t run = std::max<size_t>(value.size() / 2, 1); !value.empty(); run /= 2)
+            {
+                for (size_t begin = 0; begin + run <= value.size();)
+                {
+                    Type removed(value.begin() + begin, value.begin() + begin + run);
+                    value.erase(value.begin() + begin, value.begin() + begin + run);
+                    if (fails())
+                    {
+                        shrunk = true;
+                        continue;
+                    }
+                    value.insert(value.begin() + begin, removed.begin(), removed.end());
+                    begin += run;
+                }
+                if (run == 1)
+                {
+                    break;
+                }
+            }
+            for (auto& item : value)
+            {
+                shrunk = element.Shrink(item, fails) || shrunk;
+            }
+            return shrunk;
+        }
+    };
+
+    // The values of one case, one per generator
+    template <typename Generators> struct PropertyCase;
+    template <typename... Generators> struct PropertyCase<std::tuple<Generators...>>
+    {
+        using Type = std::tuple<typename Generators::Type...>;
+    };
+    template <typename Generators> using PropertyCaseOf = typename PropertyCase<std::remove_const_t<Generators>>::Type;
+
+    // Runs a PROPERTY: the seeds of its corpus first, then --property-cases random cases, in batches between which the time
+    // is checked against half of the test's timeout. The first failing case is shrunk to a minimal counterexample, which is
+    // then run once more with its failures reported. Every case is generated from its own seed, so the cases depend only on
+    // the test's key and --seed, whatever the order and the number of jobs.
+    class Property
+    {
+        using Clock = std::chrono::steady_clock;
+
+        static constexpr size_t s_BatchSize  = 1024;
+        static constexpr size_t s_MaxShrinks = 10000;
+
+        inline static thread_local bool s_Failed = false;
+
+        static uint64_t Hash(std::string_view key)
+        {
+            uint64_t hash = 0xcbf29ce484222325;
+            for (char c : key)
+            {
+                hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3;
+            }
+            return hash;
+        }
+
+        template <typename T> static void Print(std::ostream& out, const T& value)
+        {
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                out << (value ? "true" : "false");
+            }
+            else if constexpr (std::is_integral_v<T>)
+            {
+                out << +value;
+            }
+            else
+            {
+                Write(out, value);
+            }
+        }
+
+        template <typename T> static void Print(std::ostream& out, const std::vector<T>& values)
+        {
+            out << '{';
+            for (size_t i = 0; i < values.size(); i++)
+            {
+                out << (i ? ", " : "");
+                Print(out, values[i]);
+            }
+            out << '}';
+        }
+
+        template <typename Generators, typename Case, size_t... I>
+        static void Generate(const Generators& generators, Case& values, uint64_t seed, std::index_sequence<I...>)
+        {
+            Random random(seed);
+            (std::get<I>(generators).Generate(random, std::get<I>(values)), ...);
+        }
+
+        template <typename Generators, typename Case, typename Fails, size_t... I>
+        static bool Shrink(const Generators& generators, Case& values, const Fails& fails, std::index_sequence<I...>)
+        {
+            bool shrunk = false;
+            ((shrunk = std::get<I>(generators).Shrink(std::get<I>(values), fails) || shrunk), ...);
+            return shrunk;
+        }
+
+        template <typename Case, size_t... I> static void Print(std::ostream& out, const Case& values, std::index_sequence<I...>)
+        {
+            ((out << (I ? ", " : ""), Print(out, std::get<I>(values))), ...);
+        }
+
+      public:
+        // Called by the assertions in a property's body in place of failing the test
+        static void Fail() { s_Failed = true; }
+
+        template <typename Generators, typename Case>
+        static void Run(FunctionInfo& test, int line, const Generators& generators, Case& values, void (*body)())
+        {
+            constexpr auto indices = std::make_index_sequence<std::tuple_size_v<Case>>();
+            const auto& options    = FunctionMap::GetOptions();
+            std::string key        = FunctionMap::Key(test);
+            auto& corpus           = FunctionMap::GetCorpus();
+
+            auto fails = [&]() {
+                s_Failed = false;
+                body();
+                return s_Failed;
+            };
+
+            // The failures of all but the final run are not reported
+            std::ostream quiet(nullptr);
+            std::ostream* out = FunctionMap::Redirect(&quiet);
+
+            size_t cases   = 0;
+            bool found     = false;
+            uint64_t seed  = 0;
+            auto startTime = Clock::now();
+            if (auto seeds = corpus.Find(key))
+            {
+                for (size_t i = 0; i < seeds->size() && !found; i++)
+                {
+                    seed = (*seeds)[i];
+                    Generate(generators, values, seed, indices);
+                    cases++;
+                    found = fails();
+                }
+            }
+
+            auto budget = std::chrono::milliseconds(FunctionMap::Timeout(test) / 2);
+            uint64_t base = Hash(key) ^ options.seed;
+            for (size_t batch = 0; batch < options.propertyCases && !found; batch += s_BatchSize)
+            {
+                for (size_t i = batch; i < std::min(batch + s_BatchSize, options.propertyCases) && !found; i++)
+                {
+                    uint64_t state = base + i;
+                    seed           = Random::SplitMix(state);
+                    Generate(generators, values, seed, indices);
+                    cases++;
+                    found = fails();
+                }
+                if (budget.count() != 0 && Clock::now() - startTime > budget)
+                {
+                    break;
+                }
+            }
+            auto qs = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - startTime).count();
+
+            if (!found)
+            {
+                FunctionMap::Redirect(out);
+                FunctionMap::Out() << "  " << cases << " cases in " << qs / 1000 << " ms ("
+                                   << static_cast<uint64_t>(cases * 1e6 / std::max<int64_t>(qs, 1)) << " cases/s)\n";
+                return;
+            }
+
+            size_t shrinks  = 0;
+            auto shrinkable = [&]() { return shrinks++ < s_MaxShrinks && fails(); };
+            while (Shrink(generators, values, shrinkable, indices))
+            {
+            }
+
+            FunctionMap::Redirect(out);
+            fails();
+            FunctionMap::Fail(test);
+            auto& report = ReportBuffer::Begin(line);
+            report << "Falsified after " << cases << " cases by seed " << seed << ", minimal counterexample after "
+                   << std::min(shrinks, s_MaxShrinks) << " shrinks: (";
+            Print(report, values, indices);
+            report << ')';
+            ReportBuffer::End();
+            corpus.Add(key, seed);
+        }
+    };
+} // namespace EVA::TEST
+
+// Checks the body against random cases from the generators, such as EVA::TEST::Int(-100, 100) or
+// EVA::TEST::Vector(EVA::TEST::Real(0.0, 1.0), 16). The body reads the values of the case with Arg<I>().
+#define PROPERTY(CATEGORY, NAME, ...)                                                                                                      \
+    struct Property_##CATEGORY##NAME                                                                                                       \
+    {                                                                                                                                      \
+        static constexpr auto s_Generators = std::make_tuple(__VA_ARGS__);                                                                 \
+        using Case                         = EVA::TEST::PropertyCaseOf<decltype(s_Generators)>;                                            \
+        inline static thread_local const Case* s_Case = nullptr;                                                                           \
+        static void Body();                                                                                                                \
+        static void Run()                                                                                                                  \
+        {                                                                                                                                  \
+            Case values;                                                                                                                   \
+            s_Case = &values;                                                                                                              \
+            EVA::TEST::Property::Run(s_Info, __LINE__, s_Generators, values, &Body);                                                       \
+            s_Case = nullptr;                                                                                                              \
+        }                                                                                                                                  \
+        template <size_t I> static const auto& Arg() { return std::get<I>(*s_Case); }                                                      \
+        inline static EVA::TEST::FunctionInfo s_Info = { &Run, #NAME, #CATEGORY, __FILE__ };                                               \
+        Property_##CATEGORY##NAME() { EVA::TEST::FunctionMap::Add(s_Info); }                                                               \
+        inline static void Fail() { EVA::TEST::Property::Fail(); }                                                                         \
+    };                                                                                                                                     \
+    inline static Property_##CATEGORY##NAME property_##CATEGORY##NAME;                                                                     \
+    void Property_##CATEGORY##NAME::Body()
@@ -0,0 +1,417 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <immintrin.h>
+    #define EVA_TEST_SSE2 1
+#else
+    #define EVA_TEST_SSE2 0
+#endif
+
+#if EVA_TEST_SSE2 && (defined(__GNUC__) || defined(__clang__))
+    #define EVA_TEST_AVX2        1
+    #define EVA_TEST_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+    #define EVA_TEST_AVX2 0
+#endif
+
+#include "Test.hpp"
+
+namespace EVA::TEST
+{
+    // Tolerance in units in the last place, for EXPECT_NEAR_ALL
+    struct Ulps
+    {
+        uint64_t count;
+    };
+
+    // The kernels return the first index from i on whose elements do not match, or where their vector loop stopped.
+    // The scalar loop in the callers finishes the tail.
+    namespace Simd
+    {
+        inline unsigned CountTrailingZeros(unsigned mask)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_ctz(mask);
+#else
+            unsigned count = 0;
+            while (!(mask & 1))
+            {
+                mask >>= 1;
+                count++;
+            }
+            return count;
+#endif
+        }
+
+#if EVA_TEST_SSE2
+        inline size_t Mismatch(const float* a, const float* b, size_t n, size_t i)
+        {
+            for (; i + 4 <= n; i += 4)
+            {
+                unsigned mask = _mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+                if (mask != 0xF)
+                {
+                    return i + CountTrailingZeros(~mask);
+                }
+            }
+            return i;
+        }
+
+        inline size_t Mismatch(const double* a, const double* b, size_t n, size_t i)
+        {
+            for (; i + 2 <= n; i += 2)
+            {
+                unsigned mask = _mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+                if (mask != 0x3)
+                {
+                    return i + CountTrailingZeros(~mask);
+                }
+            }
+            return i;
+        }
+
+        inline size_t NotNear(const float* a, const float* b, size_t n, size_t i, float tolerance)
+        {
+            __m128 sign  = _mm_set1_ps(-0.0f);
+            __m128 limit = _mm_set1_ps(tolerance);
+            for (; i + 4 <= n; i += 4)
+            {
+                __m128 difference = _mm_andnot_ps(sign, _mm_sub_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+                unsigned mask     = _mm_movemask_ps(_mm_cmple_ps(difference, limit));
+                if (mask != 0xF)
+                {
+                    return i + CountTrailingZeros(~mask);
+                }
+            }
+            return i;
+        }
+
+        inline size_t NotNear(const double* a, const double* b, size_t n, size_t i, double tolerance)
+        {
+            __m128d sign  = _mm_set1_pd(-0.0);
+            __m128d limit = _mm_set1_pd(tolerance);
+            for (; i + 2 <= n; i += 2)
+            {
+                __m128d difference = _mm_andnot_pd(sign, _mm_sub_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+                unsigned mask      = _mm_movemask_pd(_mm_cmple_pd(difference, limit));
+                if (mask != 0x3)
+                {
+                    return i + CountTrailingZeros(~mask);
+                }
+            }
+            return i;
+        }
+#endif
+
+#if EVA_TEST_AVX2
+        inline bool HasAvx2()
+        {
+            static const bool avx2 = __builtin_cpu_supports("avx2");
+            return avx2;
+        }
+
+        EVA_TEST_TARGET_AVX2 inline size_t MismatchAvx2(const float* a, const float* b, size_t n, size_t i)
+        {
+            for (; i + 8 <= n; i += 8)
+            {
+                unsigned mask = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), _CMP_EQ_OQ));
+                if (mask != 0xFF)
+                {
+                    return i + CountTrailingZeros(~mask);
+                }
+            }
+            return i;
+        }
+
+        EVA_TEST_TARGET_AVX2 inline size_t MismatchAvx2(const double* a, const double* b, size_t n, size_t i)
+        {
+            for (; i + 4 <= n; i += 4)
+            {
+                unsigned mask = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), _CMP_EQ_OQ));
+                if (mask != 0xF)
+                {
+                    return i + CountTrailingZeros(~mask);
+                }
+            }
+            return i;
+        }
+
+        EVA_TEST_TARGET_AVX2 inline size_t NotNearAvx2(const float* a, const float* b, size_t n, size_t i, float tolerance)
+        {
+            __m256 sign  = _mm256_set1_ps(-0.0f);
+            __m256 limit = _mm256_set1_ps(tolerance);
+            for (; i + 8 <= n; i += 8)
+            {
+                __m256 difference = _mm256_andnot_ps(sign, _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+                unsigned mask     = _mm256_movemask_ps(_mm256_cmp_ps(difference, limit, _CMP_LE_OQ));
+                if (mask != 0xFF)
+                {
+                    return i + CountTrailingZeros(~mask);
+                }
+            }
+            return i;
+        }
+
+        EVA_TEST_TARGET_AVX2 inline size_t NotNearAvx2(const double* a, const double* b, size_t n, size_t i, double tolerance)
+        {
+            __m256d sign  = _mm256_set1_pd(-0.0);
+            __m256d limit = _mm256_set1_pd(tolerance);
+            for (; i + 4 <= n; i += 4)
+            {
+                __m256d difference = _mm256_andnot_pd(sign, _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+                unsigned mask      = _mm256_movemask_pd(_mm256_cmp_pd(difference, limit, _CMP_LE_OQ));
+                if (mask != 0xF)
+                {
+                    return i + CountTrailingZeros(~mask);
+                }
+            }
+            return i;
+        }
+
+        // Maps the floats to unsigned keys that are ordered like the values, see OrderedKey
+        EVA_TEST_TARGET_AVX2 inline __m256i OrderedKeyAvx2(__m256 values)
+        {
+            __m256i bits      = _mm256_castps_si256(values);
+            __m256i bias      = _mm256_set1_epi32(static_cast<int>(0x80000000u));
+            __m256i magnitude = _mm256_and_si256(bits, _mm256_set1_epi32(0x7FFFFFFF));
+            return _mm256_blendv_epi8(_mm256_add_epi32(bias, magnitude), _mm256_sub_epi32(bias, magnitude), _mm256_srai_epi32(bits, 31));
+        }
+
+        EVA_TEST_TARGET_AVX2 inline size_t NotNearAvx2(const float* a, const float* b, size_t n, size_t i, uint32_t ulps)
+        {
+            __m256i limit = _mm256_set1_epi32(static_cast<int>(ulps));
+            for (; i + 8 <= n; i += 8)
+            {
+                __m256 x           = _mm256_loadu_ps(a + i);
+                __m256 y           = _mm256_loadu_ps(b + i);
+                __m256i keyX       = OrderedKeyAvx2(x);
+                __m256i keyY       = OrderedKeyAvx2(y);
+                __m256i difference = _mm256_sub_epi32(_mm256_max_epu32(keyX, keyY), _mm256_min_epu32(keyX, keyY));
+                __m256i near       = _mm256_cmpeq_epi32(_mm256_max_epu32(difference, limit), limit);
+                __m256i ordered    = _mm256_castps_si256(_mm256_cmp_ps(x, y, _CMP_ORD_Q));
+                unsigned mask      = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_and_si256(near, ordered)));
+                if (mask != 0xFF)
+                {
+                    return i + CountTrailingZeros(~mask);
+                }
+            }
+            return i;
+        }
+#endif
+    } // namespace Simd
+
+    // An unsigned key per float that is ordered like the values and counts one per representable value, so that the
+    // distance between two keys is the distance in ULPs. Both zeros map to the same key.
+    inline uint32_t OrderedKey(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits & 0x80000000u ? 0x80000000u - (bits & 0x7FFFFFFFu) : 0x80000000u + bits;
+    }
+
+    inline uint64_t OrderedKey(double value)
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        constexpr uint64_t sign = uint64_t(1) << 63;
+        return bits & sign ? sign - (bits & ~sign) : sign + bits;
+    }
+
+    template <typename T> uint64_t UlpDistance(T a, T b)
+    {
+        auto x = OrderedKey(a);
+        auto y = OrderedKey(b);
+        return x > y ? x - y : y - x;
+    }
+
+    template <typename T> size_t FindMismatch(const T* a, const T* b, size_t n, size_t i)
+    {
+        if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>)
+        {
+#if EVA_TEST_AVX2
+            if (Simd::HasAvx2())
+            {
+                i = Simd::MismatchAvx2(a, b, n, i);
+            }
+#endif
+#if EVA_TEST_SSE2
+            i = Simd::Mismatch(a, b, n, i);
+#endif
+        }
+        else if constexpr (std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>)
+        {
+            // Equal bytes mean equal values, so skip over equal blocks with memcmp
+            constexpr size_t block = sizeof(T) >= 4096 ? 1 : 4096 / sizeof(T);
+            while (i + block <= n && std::memcmp(a + i, b + i, block * sizeof(T)) == 0)
+            {
+                i += block;
+            }
+        }
+
+        for (; i < n; i++)
+        {
+            if (!(a[i] == b[i]))
+            {
+                return i;
+            }
+        }
+        return n;
+    }
+
+    template <typename T> size_t FindNotNear(const T* a, const T* b, size_t n, size_t i, T tolerance)
+    {
+        static_assert(std::is_arithmetic_v<T>, "EXPECT_NEAR_ALL needs arithmetic elements");
+        if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>)
+        {
+#if EVA_TEST_AVX2
+            if (Simd::HasAvx2())
+            {
+                i = Simd::NotNearAvx2(a, b, n, i, tolerance);
+            }
+#endif
+#if EVA_TEST_SSE2
+            i = Simd::NotNear(a, b, n, i, tolerance);
+#endif
+        }
+
+        for (; i < n; i++)
+        {
+            if (!((a[i] > b[i] ? a[i] - b[i] : b[i] - a[i]) <= tolerance))
+            {
+                return i;
+            }
+        }
+        return n;
+    }
+
+    template <typename T> size_t FindNotNear(const T* a, const T* b, size_t n, size_t i, Ulps ulps)
+    {
+        static_assert(std::is_floating_point_v<T> && sizeof(T) <= 8, "ULP tolerances need float or double elements");
+#if EVA_TEST_AVX2
+        if constexpr (std::is_same_v<T, float>)
+        {
+            if (Simd::HasAvx2() && ulps.count <= 0xFFFFFFFFu)
+            {
+                i = Simd::NotNearAvx2(a, b, n, i, static_cast<uint32_t>(ulps.count));
+            }
+        }
+#endif
+
+        for (; i < n; i++)
+        {
+            if (std::isnan(a[i]) || std::isnan(b[i]) || UlpDistance(a[i], b[i]) > ulps.count)
+            {
+                return i;
+            }
+        }
+        return n;
+    }
+
+    template <typename R> using RangeElement = std::remove_cv_t<std::remove_reference_t<decltype(*std::data(std::declval<const R&>()))>>;
+
+    template <typename T, typename Tolerance> auto RangeTolerance(const Tolerance& tolerance)
+    {
+        if constexpr (std::is_same_v<Tolerance, Ulps>)
+        {
+            return tolerance;
+        }
+        else
+        {
+            return static_cast<T>(tolerance);
+        }
+    }
+
+    template <typename A, typename B> bool RangeEqual(const A& a, const B& b)
+    {
+        static_assert(std::is_same_v<RangeElement<A>, RangeElement<B>>, "The ranges need the same element type");
+        size_t n = std::size(a);
+        return n == std::size(b) && FindMismatch(std::data(a), std::data(b), n, 0) == n;
+    }
+
+    template <typename A, typename B, typename Tolerance> bool RangeNear(const A& a, const B& b, const Tolerance& tolerance)
+    {
+        static_assert(std::is_same_v<RangeElement<A>, RangeElement<B>>, "The ranges need the same element type");
+        size_t n = std::size(a);
+        return n == std::size(b) && FindNotNear(std::data(a), std::data(b), n, 0, RangeTolerance<RangeElement<A>>(tolerance)) == n;
+    }
+
+    // Reports the total number of mismatches and the first --max-mismatches of them
+    template <typename T, typename Find>
+    EVA_TEST_COLD void ReportRange(int line, const char* message, const T* a, size_t sizeA, const T* b, size_t sizeB, Find find)
+    {
+        auto& out = ReportBuffer::Begin(line);
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            out.precision(std::numeric_limits<T>::max_digits10);
+        }
+        out << message;
+        if (sizeA != sizeB)
+        {
+            out << ". Expected " << sizeB << " elements, got " << sizeA;
+            ReportBuffer::End();
+            return;
+        }
+
+        size_t count = 0;
+        for (size_t i = find(a, b, sizeA, 0); i < sizeA; i = find(a, b, sizeA, i + 1))
+        {
+            if (count++ < FunctionMap::GetOptions().maxMismatches)
+            {
+                out << "\n    [" << i << "] expected ";
+                Write(out, b[i]);
+                out << ", got ";
+                Write(out, a[i]);
+            }
+        }
+        out << "\n    " << count << " of " << sizeA << " elements differ";
+        ReportBuffer::End();
+    }
+
+    template <typename A, typename B> EVA_TEST_COLD void ReportRangeEqual(int line, const char* message, const A& a, const B& b)
+    {
+        ReportRange(line, message, std::data(a), std::size(a), std::data(b), std::size(b),
+                    [](auto x, auto y, size_t n, size_t i) { return FindMismatch(x, y, n, i); });
+    }
+
+    template <typename A, typename B, typename Tolerance>
+    EVA_TEST_COLD void ReportRangeNear(int line, const char* message, const A& a, const B& b, const Tolerance& tolerance)
+    {
+        auto limit = RangeTolerance<RangeElement<A>>(tolerance);
+        ReportRange(line, message, std::data(a), std::size(a), std::data(b), std::size(b),
+                    [limit](auto x, auto y, size_t n, size_t i) { return FindNotNear(x, y, n, i, limit); });
+    }
+} // namespace EVA::TEST
+
+#define EXPECT_RANGE_EQ(A, B)                                                                                                              \
+    if (EVA_TEST_UNLIKELY(!EVA::TEST::RangeEqual((A), (B))))                                                                               \
+    {                                                                                                                                      \
+        Fail();                                                                                                                            \
+        EVA::TEST::ReportRangeEqual(__LINE__, "Expected the ranges to be equal", (A), (B));                                                \
+    }
+#define EXPECT_NEAR_ALL(A, B, TOLERANCE)                                                                                                   \
+    if (EVA_TEST_UNLIKELY(!EVA::TEST::RangeNear((A), (B), (TOLERANCE))))                                                                   \
+    {                                                                                                                                      \
+        Fail();                                                                                                                            \
+        EVA::TEST::ReportRangeNear(__LINE__, "Expected the ranges to be near", (A), (B), (TOLERANCE));                                     \
+    }
+
+#define ASSERT_RANGE_EQ(A, B)                                                                                                              \
+    if (EVA_TEST_UNLIKELY(!EVA::TEST::RangeEqual((A), (B))))                                                                               \
+    {                                                                                                                                      \
+        Fail();                                                                                                                            \
+        EVA::TEST::ReportRangeEqual(__LINE__, "Assertion failed. Expected the ranges to be equal", (A), (B));                              \
+        return;                                                                                                                            \
+    }
+#define ASSERT_NEAR_ALL(A, B, TOLERANCE)                                                                                                   \
+    if (EVA_TEST_UNLIKELY(!EVA::TEST::RangeNear((A), (B), (TOLERANCE))))                                                                   \
+    {                                                                                                                                      \
+        Fail();                                                                                                                            \
+        EVA::TEST::ReportRangeNear(__LINE__, "Assertion failed. Expected the ranges to be near", (A), (B), (TOLERANCE));                   \
+        return;                                                                                                                            \
+    }
@@ -0,0 +1,461 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "Baseline.hpp"
+#include "Histogram.hpp"
+#include "Instrument.hpp"
+
+namespace EVA::TEST
+{
+    constexpr const char* EVA_TEST_COLOR_RED      = "\x1B[31m";
+    constexpr const char* EVA_TEST_COLOR_GREEN    = "\x1B[32m";
+    constexpr const char* EVA_TEST_COLOR_STANDARD = "\033[0m";
+
+    // Intrusive multi-producer, single-consumer queue. Producers push with a CAS, the consumer takes everything at once.
+    template <typename T> class EventQueue
+    {
+        std::atomic<T*> m_Head{ nullptr };
+
+      public:
+        void Push(T* item)
+        {
+            item->next = m_Head.load(std::memory_order_relaxed);
+            while (!m_Head.compare_exchange_weak(item->next, item, std::memory_order_release, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        // Returns the pushed items, newest first
+        T* TakeAll() { return m_Head.exchange(nullptr, std::memory_order_acquire); }
+    };
+
+    // Collects a reporter's output and writes it in large blocks
+    class Sink
+    {
+        std::string m_Buffer;
+        std::ofstream m_File;
+        std::ostream* m_Stream;
+
+      public:
+        static constexpr size_t s_BlockSize = 1 << 16;
+
+        Sink() : m_Stream(&std::cout) { m_Buffer.reserve(s_BlockSize); }
+
+        explicit Sink(const std::string& path) : m_File(path, std::ios::binary | std::ios::trunc), m_Stream(&m_File)
+        {
+            m_Buffer.reserve(s_BlockSize);
+        }
+
+        ~Sink() { Flush(); }
+
+        bool IsOpen() const { return m_Stream != &m_File || m_File.is_open(); }
+
+        void Write(const char* data, size_t size)
+        {
+            m_Buffer.append(data, size);
+            if (m_Buffer.size() >= s_BlockSize)
+            {
+                Flush();
+            }
+        }
+
+        Sink& operator<<(std::string_view text)
+        {
+            Write(text.data(), text.size());
+            return *this;
+        }
+
+        Sink& operator<<(const char* text)
+        {
+            Write(text, std::char_traits<char>::length(text));
+            return *this;
+        }
+
+        Sink& operator<<(char c)
+        {
+            Write(&c, 1);
+            return *this;
+        }
+
+        template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>> Sink& operator<<(T value)
+        {
+            return *this << std::to_string(value);
+        }
+
+        void Flush()
+        {
+            if (!m_Buffer.empty())
+            {
+                m_Stream->write(m_Buffer.data(), m_Buffer.size());
+                m_Stream->flush();
+                m_Buffer.clear();
+            }
+        }
+    };
+
+    struct TestEvent
+    {
+        std::string_view category;
+        std::string_view name;
+        std::string_view file;
+        bool failed;
+        size_t qs;
+        const Measurement& measurement;
+        const Usage* usage;
+        const Histogram* histogram;
+        size_t failedRuns;
+        const std::string& output;
+    };
+
+    // A test's resource usage, for the report of the most expensive tests
+    struct Profile
+    {
+        std::string_view category;
+        std::string_view name;
+        size_t qs;
+        Usage usage;
+
+        static uint64_t Value(const Profile& profile, const std::string& sort)
+        {
+            if (sort == "user")
+            {
+                return profile.usage.userQs;
+            }
+            if (sort == "system")
+            {
+                return profile.usage.systemQs;
+            }
+            if (sort == "allocations")
+            {
+                return profile.usage.allocations;
+            }
+            if (sort == "bytes")
+            {
+                return profile.usage.bytes;
+            }
+            if (sort == "rss")
+            {
+                return profile.usage.peakRss;
+            }
+            return profile.qs;
+        }
+
+        static bool Sorts(const std::string& sort)
+        {
+            return sort == "wall" || sort == "user" || sort == "system" || sort == "allocations" || sort == "bytes" || sort == "rss";
+        }
+
+        // Keeps the top profiles by the sort key, largest first
+        static void Sort(std::vector<Profile>& profiles, const std::string& sort, size_t top)
+        {
+            top = std::min(top, profiles.size());
+            std::partial_sort(profiles.begin(), profiles.begin() + top, profiles.end(),
+                              [&](const Profile& a, const Profile& b) { return Value(a, sort) > Value(b, sort); });
+            profiles.resize(top);
+        }
+    };
+
+    struct RunSummary
+    {
+        size_t numTests;
+        size_t numPassed;
+        size_t qs;
+        std::vector<std::pair<std::string, std::string>> failed;
+        std::vector<Profile> profiles;
+        std::string sortedBy;
+        size_t numSkipped = 0;
+    };
+
+    // Receives the results in registration order, on a single thread
+    class Reporter
+    {
+      public:
+        virtual ~Reporter() = default;
+
+        virtual void Begin(size_t numTests, size_t numCategories) {}
+        virtual void BeginCategory(std::string_view category, size_t numTests) {}
+        virtual void Test(const TestEvent& event) = 0;
+        virtual void EndCategory(std::string_view category, size_t numTests, size_t numPassed, size_t qs) {}
+        virtual void End(const RunSummary& summary) {}
+        virtual void Flush() {}
+    };
+
+    class ConsoleReporter : public Reporter
+    {
+        Sink m_Sink;
+        bool m_Terse;
+        std::vector<std::string> m_Flaky;
+
+      public:
+        explicit ConsoleReporter(bool terse) : m_Terse(terse) {}
+
+        void Begin(size_t numTests, size_t numCategories) override
+        {
+            m_Sink << "Running " << numTests << " tests from " << numCategories << " test suites.\n";
+        }
+
+        void BeginCategory(std::string_view category, size_t numTests) override
+        {
+            if (!m_Terse)
+            {
+                m_Sink << numTests << " tests in " << category << '\n';
+            }
+        }
+
+        void Test(const TestEvent& event) override
+        {
+            if (m_Terse && !event.failed)
+            {
+                return;
+            }
+            m_Sink << event.category << "::" << event.name << '\n';
+            m_Sink.Write(event.output.data(), event.output.size());
+            if (event.histogram)
+            {
+                const auto& histogram = *event.histogram;
+                char line[160];
+                std::snprintf(line, sizeof(line), "  %llu runs, %llu failed, p50 %.3f us, p99 %.3f us, p99.9 %.3f us, max %.3f us\n",
+                              static_cast<unsigned long long>(histogram.Count()), static_cast<unsigned long long>(event.failedRuns),
+                              histogram.Percentile(0.5) / 1e3, histogram.Percentile(0.99) / 1e3, histogram.Percentile(0.999) / 1e3,
+                              histogram.Max() / 1e3);
+                m_Sink << line;
+                if (event.failedRuns != 0 && event.failedRuns != histogram.Count())
+                {
+                    std::snprintf(line, sizeof(line), " (%llu of %llu runs failed, %.2f%%)",
+                                  static_cast<unsigned long long>(event.failedRuns), static_cast<unsigned long long>(histogram.Count()),
+                                  100.0 * event.failedRuns / histogram.Count());
+                    m_Flaky.push_back(std::string(event.category) + "::" + std::string(event.name) + line);
+                }
+            }
+            if (event.failed)
+            {
+                m_Sink << EVA_TEST_COLOR_RED << "  Failed" << EVA_TEST_COLOR_STANDARD << " (" << event.qs / 1000 << " ms)\n";
+            }
+            else
+            {
+                m_Sink << EVA_TEST_COLOR_GREEN << "  Passed" << EVA_TEST_COLOR_STANDARD << " (" << event.qs / 1000 << " ms)\n";
+            }
+        }
+
+        void EndCategory(std::string_view category, size_t numTests, size_t numPassed, size_t qs) override
+        {
+            if (!m_Terse)
+            {
+                m_Sink << (numPassed == numTests ? EVA_TEST_COLOR_GREEN : EVA_TEST_COLOR_RED) << numPassed << " of " << numTests
+                       << EVA_TEST_COLOR_STANDARD << " tests passed in " << category << " (" << qs / 1000 << " ms)\n\n";
+            }
+        }
+
+        void End(const RunSummary& summary) override
+        {
+            m_Sink << (summary.numPassed == summary.numTests ? EVA_TEST_COLOR_GREEN : EVA_TEST_COLOR_RED) << summary.numPassed << " of "
+                   << summary.numTests << EVA_TEST_COLOR_STANDARD << " total tests passed"
+                   << " (" << summary.qs / 1000 << " ms)\n";
+            if (summary.numSkipped != 0)
+            {
+                m_Sink << "Stopped after a failure, " << summary.numSkipped << " tests were not run\n";
+            }
+
+            for (const auto& [category, name] : summary.failed)
+            {
+                m_Sink << EVA_TEST_COLOR_RED << category << " - " << name << EVA_TEST_COLOR_STANDARD << '\n';
+            }
+
+            if (!m_Flaky.empty())
+            {
+                m_Sink << "\n" << m_Flaky.size() << " flaky tests\n";
+                for (const auto& flaky : m_Flaky)
+                {
+                    m_Sink << "  " << flaky << '\n';
+                }
+            }
+
+            if (!summary.profiles.empty())
+            {
+                char line[160];
+                m_Sink << "\nTop " << summary.profiles.size() << " tests by " << summary.sortedBy << '\n';
+                m_Sink << "     wall ms     user ms   system ms  allocations        bytes  peak RSS KiB  test\n";
+                for (const auto& profile : summary.profiles)
+                {
+                    std::snprintf(line, sizeof(line), "%12.3f%12.3f%12.3f%13llu%13llu%14llu  ", profile.qs / 1e3, profile.usage.userQs / 1e3,
+                                  profile.usage.systemQs / 1e3, static_cast<unsigned long long>(profile.usage.allocations),
+                                  static_cast<unsigned long long>(profile.usage.bytes), static_cast<unsigned long long>(profile.usage.peakRss));
+                    m_Sink << line << profile.category << "::" << profile.name << '\n';
+                }
+            }
+            m_Sink.Flush();
+        }
+
+        void Flush() override { m_Sink.Flush(); }
+    };
+
+    inline std::string EscapeXml(std::string_view text)
+    {
+        std::string escaped;
+        escaped.reserve(text.size());
+        for (char c : text)
+        {
+            switch (c)
+            {
+                case '&': escaped += "&amp;"; break;
+                case '<': escaped += "&lt;"; break;
+                case '>': escaped += "&gt;"; break;
+                case '"': escaped += "&quot;"; break;
+                case '\'': escaped += "&apos;"; break;
+                default:
+                    if (static_cast<unsigned char>(c) >= 0x20 || c == '\n' || c == '\t' || c == '\r')
+                    {
+                        escaped += c;
+                    }
+            }
+        }
+        return escaped;
+    }
+
+    inline std::string EscapeJson(std::string_view text)
+    {
+        std::string escaped;
+        escaped.reserve(text.size());
+        for (char c : text)
+        {
+            switch (c)
+            {
+                case '"': escaped += "\\\""; break;
+                case '\\': escaped += "\\\\"; break;
+                case '\n': escaped += "\\n"; break;
+                case '\r': escaped += "\\r"; break;
+                case '\t': escaped += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20)
+                    {
+                        char code[8];
+                        std::snprintf(code, sizeof(code), "\\u%04x", c);
+                        escaped += code;
+                    }
+                    else
+                    {
+                        escaped += c;
+                    }
+            }
+        }
+        return escaped;
+    }
+
+    inline std::string Seconds(size_t qs)
+    {
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.6f", qs / 1e6);
+        return text;
+    }
+
+    // JUnit needs the totals in front of the test cases, so the document is built up and written at the end
+    class JUnitReporter : public Reporter
+    {
+        Sink m_Sink;
+        std::string m_Suites;
+        std::string m_Cases;
+        size_t m_Failures = 0;
+
+      public:
+        explicit JUnitReporter(const std::string& path) : m_Sink(path) {}
+
+        bool IsOpen() const { return m_Sink.IsOpen(); }
+
+        void Test(const TestEvent& event) override
+        {
+            m_Cases += "    <testcase classname=\"" + EscapeXml(event.category) + "\" name=\"" + EscapeXml(event.name) + "\" file=\""
+                       + EscapeXml(event.file) + "\" time=\"" + Seconds(event.qs) + "\"";
+            if (!event.failed && event.output.empty())
+            {
+                m_Cases += "/>\n";
+                return;
+            }
+            m_Cases += ">\n";
+            if (event.failed)
+            {
+                m_Failures++;
+                m_Cases += "      <failure message=\"Failed\">" + EscapeXml(event.output) + "</failure>\n";
+            }
+            else
+            {
+                m_Cases += "      <system-out>" + EscapeXml(event.output) + "</system-out>\n";
+            }
+            m_Cases += "    </testcase>\n";
+        }
+
+        void EndCategory(std::string_view category, size_t numTests, size_t, size_t qs) override
+        {
+            m_Suites += "  <testsuite name=\"" + EscapeXml(category) + "\" tests=\"" + std::to_string(numTests) + "\" failures=\""
+                        + std::to_string(m_Failures) + "\" time=\"" + Seconds(qs) + "\">\n" + m_Cases + "  </testsuite>\n";
+            m_Cases.clear();
+            m_Failures = 0;
+        }
+
+        void End(const RunSummary& summary) override
+        {
+            m_Sink << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<testsuites tests=\"" << summary.numTests << "\" failures=\""
+                   << summary.numTests - summary.numPassed << "\" time=\"" << Seconds(summary.qs) << "\">\n"
+                   << m_Suites << "</testsuites>\n";
+            m_Sink.Flush();
+        }
+    };
+
+    // One JSON object per line and event
+    class JsonReporter : public Reporter
+    {
+        Sink m_Sink;
+
+      public:
+        explicit JsonReporter(const std::string& path) : m_Sink(path) {}
+
+        bool IsOpen() const { return m_Sink.IsOpen(); }
+
+        void Begin(size_t numTests, size_t numCategories) override
+        {
+            m_Sink << "{\"event\":\"begin\",\"tests\":" << numTests << ",\"suites\":" << numCategories << "}\n";
+        }
+
+        void Test(const TestEvent& event) override
+        {
+            m_Sink << "{\"event\":\"test\",\"category\":\"" << EscapeJson(event.category) << "\",\"name\":\"" << EscapeJson(event.name)
+                   << "\",\"file\":\"" << EscapeJson(event.file) << "\",\"passed\":" << (event.failed ? "false" : "true")
+                   << ",\"us\":" << event.qs << ",\"median_ns\":" << event.measurement.median;
+            if (event.usage)
+            {
+                m_Sink << ",\"user_us\":" << event.usage->userQs << ",\"system_us\":" << event.usage->systemQs
+                       << ",\"allocations\":" << event.usage->allocations << ",\"bytes\":" << event.usage->bytes
+                       << ",\"peak_rss_kib\":" << event.usage->peakRss;
+            }
+            if (event.histogram)
+            {
+                m_Sink << ",\"runs\":" << event.histogram->Count() << ",\"failed_runs\":" << event.failedRuns
+                       << ",\"p50_ns\":" << event.histogram->Percentile(0.5) << ",\"p99_ns\":" << event.histogram->Percentile(0.99)
+                       << ",\"p999_ns\":" << event.histogram->Percentile(0.999) << ",\"max_ns\":" << event.histogram->Max();
+            }
+            m_Sink << ",\"output\":\"" << EscapeJson(event.output) << "\"}\n";
+        }
+
+        void EndCategory(std::string_view category, size_t numTests, size_t numPassed, size_t qs) override
+        {
+            m_Sink << "{\"event\":\"suite\",\"category\":\"" << EscapeJson(category) << "\",\"tests\":" << numTests
+                   << ",\"passed\":" << numPassed << ",\"us\":" << qs << "}\n";
+        }
+
+        void End(const RunSummary& summary) override
+        {
+            m_Sink << "{\"event\":\"end\",\"tests\":" << summary.numTests << ",\"passed\":" << summary.numPassed << ",\"us\":" << summary.qs
+                   << "}\n";
+            m_Sink.Flush();
+        }
+
+        void Flush() override { m_Sink.Flush(); }
+    };
+} // namespace EVA::TEST
@@ -0,0 +1,125 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace EVA::TEST
+{
+    // Runs the tasks [0, count) on a pool of worker threads. Each worker owns a contiguous range of task indices and takes
+    // from the front of it. A worker that runs dry steals the back half of another worker's range. Both ends of a range are
+    // packed into one atomic word, so neither taking nor stealing needs a lock.
+    class Scheduler
+    {
+        struct alignas(64) Range
+        {
+            std::atomic<uint64_t> bounds{ 0 };
+        };
+
+        std::vector<Range> m_Ranges;
+        std::vector<std::thread> m_Threads;
+        std::function<void(size_t)> m_Task;
+        std::atomic<bool> m_Stopped{ false };
+
+        inline static thread_local size_t s_Worker = 0;
+
+        static uint64_t Pack(uint64_t begin, uint64_t end) { return (begin << 32) | end; }
+        static uint32_t Begin(uint64_t bounds) { return static_cast<uint32_t>(bounds >> 32); }
+        static uint32_t End(uint64_t bounds) { return static_cast<uint32_t>(bounds); }
+
+        bool Take(size_t worker, size_t& index)
+        {
+            auto& range     = m_Ranges[worker].bounds;
+            uint64_t bounds = range.load(std::memory_order_acquire);
+            while (Begin(bounds) < End(bounds))
+            {
+                if (range.compare_exchange_weak(bounds, Pack(Begin(bounds) + 1, End(bounds)), std::memory_order_acq_rel))
+                {
+                    index = Begin(bounds);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool Steal(size_t worker)
+        {
+            for (size_t i = 1; i < m_Ranges.size(); i++)
+            {
+                auto& range     = m_Ranges[(worker + i) % m_Ranges.size()].bounds;
+                uint64_t bounds = range.load(std::memory_order_acquire);
+                while (Begin(bounds) < End(bounds))
+                {
+                    uint32_t middle = End(bounds) - (End(bounds) - Begin(bounds) + 1) / 2;
+                    if (range.compare_exchange_weak(bounds, Pack(Begin(bounds), middle), std::memory_order_acq_rel))
+                    {
+                        // Our own range is empty, and thieves never write to an empty range
+                        m_Ranges[worker].bounds.store(Pack(middle, End(bounds)), std::memory_order_release);
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        void Work(size_t worker)
+        {
+            s_Worker = worker;
+            size_t index;
+            do
+            {
+                while (!m_Stopped.load(std::memory_order_relaxed) && Take(worker, index))
+                {
+                    m_Task(index);
+                }
+            } while (!m_Stopped.load(std::memory_order_relaxed) && Steal(worker));
+        }
+
+      public:
+        Scheduler(size_t count, size_t jobs, std::function<void(size_t)> task) : m_Ranges(jobs == 0 ? 1 : jobs), m_Task(std::move(task))
+        {
+            for (size_t i = 0; i < m_Ranges.size(); i++)
+            {
+                size_t begin = Split(count, m_Ranges.size(), i);
+                size_t end   = Split(count, m_Ranges.size(), i + 1);
+                m_Ranges[i].bounds.store(Pack(begin, end), std::memory_order_relaxed);
+            }
+            for (size_t i = 0; i < m_Ranges.size(); i++)
+            {
+                m_Threads.emplace_back(&Scheduler::Work, this, i);
+            }
+        }
+
+        ~Scheduler() { Wait(); }
+
+        Scheduler(const Scheduler&) = delete;
+        Scheduler& operator=(const Scheduler&) = delete;
+
+        // The workers finish their current tasks and start no more
+        void Stop() { m_Stopped.store(true, std::memory_order_relaxed); }
+
+        void Wait()
+        {
+            for (auto& thread : m_Threads)
+            {
+                if (thread.joinable())
+                {
+                    thread.join();
+                }
+            }
+        }
+
+        // Where the range of the given worker begins
+        static size_t Split(size_t count, size_t jobs, size_t worker) { return count * worker / jobs; }
+
+        // The worker running the calling thread's task, 0 outside of a scheduler
+        static size_t Worker() { return s_Worker; }
+
+        static size_t HardwareJobs()
+        {
+            size_t jobs = std::thread::hardware_concurrency();
+            return jobs == 0 ? 1 : jobs;
+        }
+    };
+} // namespace EVA::TEST
@@ -0,0 +1,84 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <optional>
+
+namespace EVA::TEST
+{
+    // Resources built during a run, released together once it is over
+    class SharedResource
+    {
+        inline static SharedResource* s_Built = nullptr;
+        inline static std::mutex s_BuiltMutex;
+
+        SharedResource* m_Next = nullptr;
+
+      protected:
+        constexpr SharedResource() = default;
+        ~SharedResource()          = default;
+
+        void Built()
+        {
+            std::lock_guard<std::mutex> lock(s_BuiltMutex);
+            m_Next  = s_Built;
+            s_Built = this;
+        }
+
+        virtual void Release() = 0;
+
+      public:
+        SharedResource(const SharedResource&) = delete;
+        SharedResource& operator=(const SharedResource&) = delete;
+
+        static void ReleaseAll()
+        {
+            std::lock_guard<std::mutex> lock(s_BuiltMutex);
+            for (SharedResource* resource = s_Built; resource;)
+            {
+                SharedResource* next = resource->m_Next;
+                resource->Release();
+                resource->m_Next = nullptr;
+                resource         = next;
+            }
+            s_Built = nullptr;
+        }
+    };
+
+    // An expensive resource for the tests to share, such as a large dataset. It is built by whichever test uses it first,
+    // while any other worker that needs it waits, and kept until the end of the run. The tests only get to read it.
+    //   inline static EVA::TEST::Shared<Dataset> s_Data{ [] { return Dataset::Load("data.bin"); } };
+    template <typename T> class Shared final : public SharedResource
+    {
+        T (*m_Build)();
+        std::atomic<bool> m_Ready{ false };
+        std::mutex m_Mutex;
+        std::optional<T> m_Value;
+
+        void Release() override
+        {
+            m_Value.reset();
+            m_Ready.store(false, std::memory_order_relaxed);
+        }
+
+      public:
+        constexpr explicit Shared(T (*build)()) : m_Build(build) {}
+
+        const T& Get()
+        {
+            if (!m_Ready.load(std::memory_order_acquire))
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                if (!m_Ready.load(std::memory_order_relaxed))
+                {
+                    m_Value.emplace(m_Build());
+                    Built();
+                    m_Ready.store(true, std::memory_order_release);
+                }
+            }
+            return *m_Value;
+        }
+
+        const T& operator*() { return Get(); }
+        const T* operator->() { return &Get(); }
+    };
+} // namespace EVA::TEST
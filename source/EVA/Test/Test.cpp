@@ -1 +1,58 @@
 #include "Test.hpp"
+
+#ifndef EVA_TEST_NO_ALLOCATION_HOOK
+    #include <cstdlib>
+    #include <new>
+
+namespace
+{
+    // Inlined into operator new, so that a captured trace starts with a fixed number of hook frames
+    EVA_TEST_ALWAYS_INLINE void* Allocate(std::size_t size, std::size_t alignment)
+    {
+        EVA::TEST::Allocations::Record(size);
+        size = size == 0 ? 1 : size;
+        for (;;)
+        {
+    #if defined(_WIN32)
+            void* memory = alignment ? _aligned_malloc(size, alignment) : std::malloc(size);
+    #else
+            void* memory = nullptr;
+            if (alignment == 0)
+            {
+                memory = std::malloc(size);
+            }
+            else if (posix_memalign(&memory, alignment, size) != 0)
+            {
+                memory = nullptr;
+            }
+    #endif
+            if (memory)
+            {
+                return memory;
+            }
+            std::new_handler handler = std::get_new_handler();
+            if (!handler)
+            {
+                throw std::bad_alloc();
+            }
+            handler();
+        }
+    }
+
+    void Free(void* memory, bool aligned)
+    {
+    #if defined(_WIN32)
+        aligned ? _aligned_free(memory) : std::free(memory);
+    #else
+        (void)aligned;
+        std::free(memory);
+    #endif
+    }
+} // namespace
+
+// The remaining forms of new and delete forward to these by default
+void* operator new(std::size_t size) { return Allocate(size, 0); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return Allocate(size, static_cast<std::size_t>(alignment)); }
+void operator delete(void* memory) noexcept { Free(memory, false); }
+void operator delete(void* memory, std::align_val_t) noexcept { Free(memory, true); }
+#endif
@@ -1,110 +1,1094 @@
 #pragma once
+#include <algorithm>
 #include <chrono>
+#include <cstdlib>
 #include <cstring>
+#include <iomanip>
 #include <iostream>
-#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
 #include <vector>
 
+#include "Baseline.hpp"
+#include "Corpus.hpp"
+#include "Failures.hpp"
+#include "Filter.hpp"
+#include "Histogram.hpp"
+#include "Instrument.hpp"
+#include "Process.hpp"
+#include "Reporter.hpp"
+#include "Scheduler.hpp"
+#include "Shared.hpp"
+#include "Timings.hpp"
+#include "Watchdog.hpp"
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define EVA_TEST_COLD        __attribute__((cold, noinline))
+    #define EVA_TEST_UNLIKELY(C) __builtin_expect(!!(C), 0)
+#elif defined(_MSC_VER)
+    #define EVA_TEST_COLD        __declspec(noinline)
+    #define EVA_TEST_UNLIKELY(C) (C)
+#else
+    #define EVA_TEST_COLD
+    #define EVA_TEST_UNLIKELY(C) (C)
+#endif
+
 namespace EVA::TEST
 {
-    constexpr char* EVA_TEST_COLOR_RED      = "\x1B[31m";
-    constexpr char* EVA_TEST_COLOR_GREEN    = "\x1B[32m";
-    constexpr char* EVA_TEST_COLOR_STANDARD = "\033[0m";
-
+    // Constant initialized by the TEST macros, so registering a test only links it into the list
     struct FunctionInfo
     {
         void (*function)();
-        std::string name;
-        std::string category;
-        std::string file;
-        bool failed;
+        std::string_view name;
+        std::string_view category;
+        std::string_view file;
+        size_t timeout     = 0;
+        bool failed        = false;
+        FunctionInfo* next = nullptr;
+        size_t sequence    = 0;
+    };
+
+    struct Options
+    {
+        size_t jobs                = 1;
+        bool isolate               = false;
+        bool terse                 = false;
+        bool list                  = false;
+        bool failFast              = false;
+        bool longestFirst          = false;
+        bool instrument            = false;
+        bool allocationBacktrace   = false;
+        std::string instrumentSort = "wall";
+        size_t instrumentTop       = 10;
+        size_t timeout             = 0;
+        size_t shardIndex          = 0;
+        size_t shardCount          = 1;
+        size_t benchmarkSamples    = 20;
+        size_t benchmarkTime       = 5;
+        size_t maxMismatches       = 10;
+        size_t propertyCases       = 10000;
+        size_t repeat              = 1;
+        size_t duration            = 0;
+        uint64_t seed              = 0;
+        double regressionThreshold = 0.1;
+        std::string timings;
+        std::string baseline;
+        std::string saveBaseline;
+        std::string filter;
+        std::string failures;
+        std::string corpus;
+        std::string junit;
+        std::string json;
+
+        static bool Match(const char* arg, const char* name, const char*& value)
+        {
+            size_t length = strlen(name);
+            if (strncmp(arg, name, length) != 0 || arg[length] != '=')
+            {
+                return false;
+            }
+            value = arg + length + 1;
+            return true;
+        }
+
+        static Options Parse(int argc, char** argv)
+        {
+            Options options;
+            for (int i = 1; i < argc; i++)
+            {
+                const char* value = nullptr;
+                if (Match(argv[i], "--jobs", value))
+                {
+                    options.jobs = strtoul(value, nullptr, 10);
+                    if (options.jobs == 0)
+                    {
+                        options.jobs = Scheduler::HardwareJobs();
+                    }
+                }
+                else if (strcmp(argv[i], "--isolate") == 0)
+                {
+                    options.isolate = true;
+                }
+                else if (Match(argv[i], "--filter", value))
+                {
+                    options.filter = value;
+                }
+                else if (strcmp(argv[i], "--list") == 0)
+                {
+                    options.list = true;
+                }
+                else if (strcmp(argv[i], "--fail-fast") == 0)
+                {
+                    options.failFast = true;
+                }
+                else if (Match(argv[i], "--failures", value))
+                {
+                    options.failures = value;
+                }
+                else if (strcmp(argv[i], "--longest-first") == 0)
+                {
+                    options.longestFirst = true;
+                }
+                else if (strcmp(argv[i], "--instrument") == 0)
+                {
+                    options.instrument = true;
+                }
+                else if (Match(argv[i], "--instrument", value))
+                {
+                    options.instrument     = true;
+                    options.instrumentSort = value;
+                    if (!Profile::Sorts(value))
+                    {
+                        std::cout << "Unknown instrument sort: " << value << ", expected wall, user, system, allocations, bytes or rss"
+                                  << std::endl;
+                        options.instrumentSort = "wall";
+                    }
+                }
+                else if (strcmp(argv[i], "--allocation-backtrace") == 0)
+                {
+                    options.allocationBacktrace = true;
+                }
+                else if (Match(argv[i], "--instrument-top", value))
+                {
+                    options.instrumentTop = strtoul(value, nullptr, 10);
+                }
+                else if (strcmp(argv[i], "--terse") == 0)
+                {
+                    options.terse = true;
+                }
+                else if (Match(argv[i], "--junit", value))
+                {
+                    options.junit = value;
+                }
+                else if (Match(argv[i], "--json", value))
+                {
+                    options.json = value;
+                }
+                else if (Match(argv[i], "--timeout", value))
+                {
+                    options.timeout = strtoul(value, nullptr, 10);
+                }
+                else if (Match(argv[i], "--shard-index", value))
+                {
+                    options.shardIndex = strtoul(value, nullptr, 10);
+                }
+                else if (Match(argv[i], "--shard-count", value))
+                {
+                    options.shardCount = strtoul(value, nullptr, 10);
+                }
+                else if (Match(argv[i], "--timings", value))
+                {
+                    options.timings = value;
+                }
+                else if (Match(argv[i], "--baseline", value))
+                {
+                    options.baseline = value;
+                }
+                else if (Match(argv[i], "--save-baseline", value))
+                {
+                    options.saveBaseline = value;
+                }
+                else if (Match(argv[i], "--regression-threshold", value))
+                {
+                    options.regressionThreshold = strtod(value, nullptr) / 100;
+                }
+                else if (Match(argv[i], "--max-mismatches", value))
+                {
+                    options.maxMismatches = strtoul(value, nullptr, 10);
+                }
+                else if (Match(argv[i], "--benchmark-samples", value))
+                {
+                    options.benchmarkSamples = std::max<size_t>(strtoul(value, nullptr, 10), 1);
+                }
+                else if (Match(argv[i], "--benchmark-time", value))
+                {
+                    options.benchmarkTime = strtoul(value, nullptr, 10);
+                }
+                else if (Match(argv[i], "--property-cases", value))
+                {
+                    options.propertyCases = strtoul(value, nullptr, 10);
+                }
+                else if (Match(argv[i], "--seed", value))
+                {
+                    options.seed = strtoull(value, nullptr, 10);
+                }
+                else if (Match(argv[i], "--corpus", value))
+                {
+                    options.corpus = value;
+                }
+                else if (Match(argv[i], "--repeat", value))
+                {
+                    options.repeat = std::max<size_t>(strtoul(value, nullptr, 10), 1);
+                }
+                else if (Match(argv[i], "--duration", value))
+                {
+                    options.duration = static_cast<size_t>(strtod(value, nullptr) * 1000);
+                }
+                else
+                {
+                    std::cout << "Unknown option: " << argv[i] << std::endl;
+                }
+            }
+            return options;
+        }
     };
 
     class FunctionMap
     {
-        inline static std::map<std::string, std::vector<FunctionInfo>> s_Info = std::map<std::string, std::vector<FunctionInfo>>();
-        inline static std::vector<FunctionInfo*> s_Failed                     = std::vector<FunctionInfo*>();
+        struct Result
+        {
+            bool done    = false;
+            bool crashed = false;
+            size_t qs    = 0;
+            Measurement measurement;
+            Usage usage;
+            Histogram histogram;
+            size_t failedRuns = 0;
+            std::string output;
+            Result* next = nullptr;
+        };
+
+        inline static FunctionInfo* s_Head                = nullptr;
+        inline static size_t s_Count                      = 0;
+        inline static std::vector<FunctionInfo*> s_Failed = std::vector<FunctionInfo*>();
+        inline static std::mutex s_FailedMutex;
+        inline static thread_local std::ostream* s_Out  = &std::cout;
+        inline static thread_local Result* s_Current    = nullptr;
+        inline static thread_local FunctionInfo* s_Test = nullptr;
+        inline static thread_local bool s_RunFailed     = false;
+        inline static Options s_Options;
+
+        // All tests grouped by category in registration order, and their keys sorted for the filter, with the position of
+        // each key's test
+        struct Index
+        {
+            std::vector<FunctionInfo*> tests;
+            std::vector<std::string> keys;
+            std::vector<size_t> positions;
+        };
+
+        // Built on first use, after static registration is done
+        static const Index& GetIndex()
+        {
+            static Index index;
+            if (index.tests.size() != s_Count)
+            {
+                index = Index();
+                for (FunctionInfo* test = s_Head; test; test = test->next)
+                {
+                    index.tests.push_back(test);
+                }
+                std::reverse(index.tests.begin(), index.tests.end());
+                std::stable_sort(index.tests.begin(), index.tests.end(),
+                                 [](const FunctionInfo* a, const FunctionInfo* b) { return a->category < b->category; });
+
+                std::vector<std::pair<std::string, size_t>> keys;
+                for (size_t i = 0; i < index.tests.size(); i++)
+                {
+                    keys.emplace_back(Key(*index.tests[i]), i);
+                }
+                std::sort(keys.begin(), keys.end());
+                for (auto& [key, position] : keys)
+                {
+                    index.keys.push_back(std::move(key));
+                    index.positions.push_back(position);
+                }
+            }
+            return index;
+        }
+
+        // Isolated workers send their results to the parent as: u8 failed, u64 qs, f64 median, f64 mean, f64 stddev,
+        // u64 samples, the usage as u64s, u64 failed runs, the histogram, output
+        static constexpr size_t s_HeaderSize = 1 + 8 * 5 + 8 * 5 + 8;
+
+        static std::string Encode(const FunctionInfo& test, const Result& result)
+        {
+            std::string payload;
+            payload.reserve(s_HeaderSize + result.output.size());
+            auto put = [&](auto value) { payload.append(reinterpret_cast<const char*>(&value), sizeof(value)); };
+            put(static_cast<uint8_t>(test.failed ? 1 : 0));
+            put(static_cast<uint64_t>(result.qs));
+            put(result.measurement.median);
+            put(result.measurement.mean);
+            put(result.measurement.stddev);
+            put(static_cast<uint64_t>(result.measurement.samples));
+            put(result.usage.userQs);
+            put(result.usage.systemQs);
+            put(result.usage.allocations);
+            put(result.usage.bytes);
+            put(result.usage.peakRss);
+            put(static_cast<uint64_t>(result.failedRuns));
+            result.histogram.Encode(payload);
+            return payload + result.output;
+        }
+
+        static void Decode(FunctionInfo& test, Result& result, const std::string& payload)
+        {
+            size_t offset = 0;
+            auto get      = [&](auto& value) {
+                std::memcpy(&value, &payload[offset], sizeof(value));
+                offset += sizeof(value);
+            };
+            uint8_t failed;
+            uint64_t qs, samples, failedRuns;
+            get(failed);
+            get(qs);
+            get(result.measurement.median);
+            get(result.measurement.mean);
+            get(result.measurement.stddev);
+            get(samples);
+            get(result.usage.userQs);
+            get(result.usage.systemQs);
+            get(result.usage.allocations);
+            get(result.usage.bytes);
+            get(result.usage.peakRss);
+            get(failedRuns);
+            result.histogram.Decode(payload, offset);
+            result.qs                  = qs;
+            result.measurement.samples = samples;
+            result.failedRuns          = failedRuns;
+            result.output              = payload.substr(offset);
+            if (failed)
+            {
+                Fail(test);
+            }
+        }
+
+        // The test's output is collected and handed to the reporters together with its result
+        static void Run(FunctionInfo& test, Result& result)
+        {
+            std::ostringstream output;
+            s_Out       = &output;
+            s_Current   = &result;
+            s_Test      = &test;
+            s_RunFailed = false;
+
+            Usage usage    = s_Options.instrument ? Usage::Sample() : Usage();
+            auto startTime = std::chrono::high_resolution_clock::now();
+            if (s_Options.repeat > 1 || s_Options.duration != 0)
+            {
+                Repeat(test, result);
+            }
+            else
+            {
+                test.function();
+            }
+            result.qs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - startTime).count();
+            if (s_Options.instrument)
+            {
+                result.usage = Usage::Sample().Since(usage);
+            }
+
+            s_Out         = &std::cout;
+            s_Current     = nullptr;
+            s_Test        = nullptr;
+            result.output = output.str();
+        }
+
+        // Runs the test --repeat times, and for at least --duration, recording the time of every run. Only the output of the
+        // first run and of the first failed run is kept.
+        static void Repeat(FunctionInfo& test, Result& result)
+        {
+            using Clock = std::chrono::high_resolution_clock;
+
+            std::ostringstream scratch;
+            std::ostream* out = s_Out;
+            auto endTime      = Clock::now() + std::chrono::milliseconds(s_Options.duration);
+            for (size_t run = 0; run < s_Options.repeat || Clock::now() < endTime; run++)
+            {
+                if (run != 0)
+                {
+                    s_Out = &scratch;
+                    scratch.str(std::string());
+                }
+                s_RunFailed    = false;
+                auto startTime = Clock::now();
+                test.function();
+                result.histogram.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - startTime).count());
+                if (s_RunFailed && result.failedRuns++ == 0 && run != 0)
+                {
+                    *out << scratch.str();
+                }
+            }
+            s_Out = out;
+        }
+
+        // The time all runs of a test may take, 0 for no limit
+        static size_t TotalTimeout(const FunctionInfo& test)
+        {
+            size_t timeout = Timeout(test);
+            return timeout == 0 ? 0 : timeout * s_Options.repeat + s_Options.duration;
+        }
+
+        // Called by the watchdog thread
+        [[noreturn]] static void Hang(const std::vector<FunctionInfo*>& tests, const std::vector<Watchdog::Running>& running)
+        {
+            for (const auto& task : running)
+            {
+                if (task.overrun)
+                {
+                    std::cerr << Key(*tests[task.index]) << " has been running for " << task.elapsed << " ms, longer than its timeout of "
+                              << task.timeout << " ms\n";
+                }
+            }
+            for (const auto& task : running)
+            {
+                if (!task.overrun)
+                {
+                    std::cerr << "  " << Key(*tests[task.index]) << " is still running after " << task.elapsed << " ms\n";
+                }
+            }
+            std::cerr << "Aborting, use --isolate to kill hanging tests and continue" << std::endl;
+            std::abort();
+        }
 
       public:
-        static size_t Add(void (*function)(), std::string name, std::string category, std::string file)
+        // "category::name"
+        static std::string Key(const FunctionInfo& test)
+        {
+            std::string key;
+            key.reserve(test.category.size() + 2 + test.name.size());
+            return key.append(test.category).append("::").append(test.name);
+        }
+
+        // Safe to call from any static initializer, as the list head is constant initialized
+        static void Add(FunctionInfo& test)
+        {
+            test.next     = s_Head;
+            test.sequence = s_Count++;
+            s_Head        = &test;
+        }
+
+        static std::ostream& Out() { return *s_Out; }
+
+        // Swaps the calling thread's test output, returning the previous stream
+        static std::ostream* Redirect(std::ostream* out) { return std::exchange(s_Out, out); }
+
+        // In milliseconds, 0 for none. A test's own timeout takes precedence over --timeout.
+        static size_t Timeout(const FunctionInfo& test) { return test.timeout != 0 ? test.timeout : s_Options.timeout; }
+
+        static const Options& GetOptions() { return s_Options; }
+
+        // The seeds of the failing property cases, read from --corpus before the run
+        static Corpus& GetCorpus()
+        {
+            static Corpus corpus;
+            return corpus;
+        }
+
+        // Replaces the test's own duration as its measurement, e.g. with per iteration benchmark statistics
+        static void Record(const Measurement& measurement)
+        {
+            if (s_Current)
+            {
+                s_Current->measurement = measurement;
+            }
+        }
+
+        // Splits the tests into shards of about equal total duration, by handing the longest remaining test to the shard
+        // with the least work so far. Tests without a recorded duration count as an average one. The result only depends
+        // on the registered tests and the timings, so separate machines agree on it.
+        static std::vector<std::vector<size_t>> Partition(const std::vector<FunctionInfo*>& tests, size_t count, const Timings& timings)
         {
-            auto it = s_Info.find(category);
-            if (it == s_Info.end())
+            uint64_t fallback = timings.Empty() ? 1 : std::max<uint64_t>(timings.Mean(), 1);
+            std::vector<std::pair<uint64_t, size_t>> durations;
+            for (size_t i = 0; i < tests.size(); i++)
+            {
+                auto qs = timings.Find(Key(*tests[i]));
+                durations.emplace_back(qs ? *qs : fallback, i);
+            }
+            std::stable_sort(durations.begin(), durations.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+            std::vector<std::vector<size_t>> shards(count);
+            std::vector<uint64_t> loads(count, 0);
+            for (const auto& [qs, i] : durations)
+            {
+                size_t shard = std::min_element(loads.begin(), loads.end()) - loads.begin();
+                loads[shard] += qs;
+                shards[shard].push_back(i);
+            }
+            for (auto& shard : shards)
             {
-                auto inserted = s_Info.insert(std::pair<std::string, std::vector<FunctionInfo>>(category, {}));
-                it            = inserted.first;
+                std::sort(shard.begin(), shard.end());
             }
-            it->second.push_back(EVA::TEST::FunctionInfo{ function, name, category, file, false });
-            return it->second.size() - 1;
+            return shards;
         }
 
-        static void RunAll()
+        static int RunAll() { return RunAll(0, nullptr); }
+
+        // Returns the exit status of the run, nonzero if any test failed
+        static int RunAll(int argc, char** argv)
         {
-            size_t numTests = 0;
-            for (const auto& [category, tests] : s_Info)
+            s_Options              = Options::Parse(argc, argv);
+            const Options& options = s_Options;
+            if (options.shardCount == 0 || options.shardIndex >= options.shardCount)
+            {
+                std::cout << "Invalid shard " << options.shardIndex << " of " << options.shardCount << std::endl;
+                return 1;
+            }
+
+            Timings timings;
+            if (!options.timings.empty())
             {
-                numTests += tests.size();
+                timings.Load(options.timings);
             }
 
-            std::cout << "Running " << numTests << " tests from " << s_Info.size() << " test suites." << std::endl;
+            Baseline baseline;
+            if (!options.baseline.empty() && !baseline.Load(options.baseline))
+            {
+                std::cout << "Could not read the baseline " << options.baseline << std::endl;
+            }
 
-            size_t numPassed = 0;
-            size_t qsAll     = 0;
+            Failures failures;
+            if (!options.failures.empty())
+            {
+                failures.Load(options.failures);
+            }
 
-            for (const auto& [category, tests] : s_Info)
+            if (!options.corpus.empty())
             {
-                std::cout << tests.size() << " tests in " << category << std::endl;
+                GetCorpus().Load(options.corpus);
+            }
 
-                size_t numPassedCat = 0;
-                size_t qsCat        = 0;
+            const Index& index = GetIndex();
+            std::vector<FunctionInfo*> all;
+            if (options.filter.empty())
+            {
+                all = index.tests;
+            }
+            else
+            {
+                std::vector<size_t> selected;
+                Filter(options.filter).Select(index.keys, [&](size_t i) { selected.push_back(index.positions[i]); });
+                std::sort(selected.begin(), selected.end());
+                selected.erase(std::unique(selected.begin(), selected.end()), selected.end());
+                for (size_t position : selected)
+                {
+                    all.push_back(index.tests[position]);
+                }
+            }
 
-                for (auto& test : tests)
+            if (options.shardCount > 1)
+            {
+                auto shards = Partition(all, options.shardCount, timings);
+                std::vector<FunctionInfo*> shard;
+                for (size_t i : shards[options.shardIndex])
                 {
-                    std::cout << test.category << "::" << test.name << std::endl;
+                    shard.push_back(all[i]);
+                }
+                all = std::move(shard);
+                std::cout << "Shard " << options.shardIndex << " of " << options.shardCount << std::endl;
+            }
 
-                    auto startTime = std::chrono::high_resolution_clock::now();
-                    test.function();
-                    size_t qs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - startTime).count();
-                    qsCat += qs;
+            // The order the tests run in: the ones that failed last time first, then the longest by their recorded durations.
+            // The reporters still receive them grouped by category.
+            std::vector<size_t> order(all.size());
+            std::iota(order.begin(), order.end(), 0);
+            bool reordered = !options.failures.empty() || options.longestFirst;
+            if (reordered)
+            {
+                uint64_t fallback = timings.Mean();
+                std::vector<std::pair<bool, uint64_t>> priorities;
+                for (auto test : all)
+                {
+                    std::string key = Key(*test);
+                    auto qs         = timings.Find(key);
+                    priorities.emplace_back(failures.Contains(key), options.longestFirst ? (qs ? *qs : fallback) : 0);
+                }
+                std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+                    return priorities[a].first != priorities[b].first ? priorities[a].first : priorities[a].second > priorities[b].second;
+                });
+            }
 
-                    if (test.failed)
-                    {
-                        std::cout << EVA_TEST_COLOR_RED << "  Failed" << EVA_TEST_COLOR_STANDARD << " (" << qs / 1000 << " ms)" << std::endl;
-                    }
-                    else
+            // The scheduler hands every worker a contiguous range, so the tests are dealt out for each to start with its longest
+            if (options.longestFirst && options.jobs > 1 && !(EVA_TEST_HAS_FORK && options.isolate))
+            {
+                std::vector<size_t> positions;
+                for (size_t worker = 0; worker <= options.jobs; worker++)
+                {
+                    positions.push_back(Scheduler::Split(order.size(), options.jobs, worker));
+                }
+                std::vector<size_t> dealt(order.size());
+                size_t worker = 0;
+                for (size_t i : order)
+                {
+                    while (positions[worker] == Scheduler::Split(order.size(), options.jobs, worker + 1))
                     {
-                        numPassedCat++;
-                        std::cout << EVA_TEST_COLOR_GREEN << "  Passed" << EVA_TEST_COLOR_STANDARD << " (" << qs / 1000 << " ms)" << std::endl;
+                        worker = (worker + 1) % options.jobs;
                     }
+                    dealt[positions[worker]++] = i;
+                    worker                     = (worker + 1) % options.jobs;
                 }
+                order = std::move(dealt);
+            }
 
+            if (options.list)
+            {
+                Sink sink;
+                for (auto test : all)
+                {
+                    sink << test->category << "::" << test->name << '\n';
+                }
+                return 0;
+            }
+
+            size_t numTests      = all.size();
+            size_t numCategories = 0;
+            for (size_t i = 0; i < numTests; i++)
+            {
+                numCategories += i == 0 || all[i]->category != all[i - 1]->category;
+            }
+
+            std::vector<std::unique_ptr<Reporter>> reporters;
+            reporters.push_back(std::make_unique<ConsoleReporter>(options.terse));
+            if (!options.junit.empty())
+            {
+                auto reporter = std::make_unique<JUnitReporter>(options.junit);
+                if (reporter->IsOpen())
+                {
+                    reporters.push_back(std::move(reporter));
+                }
+                else
+                {
+                    std::cout << "Could not open " << options.junit << std::endl;
+                }
+            }
+            if (!options.json.empty())
+            {
+                auto reporter = std::make_unique<JsonReporter>(options.json);
+                if (reporter->IsOpen())
+                {
+                    reporters.push_back(std::move(reporter));
+                }
+                else
+                {
+                    std::cout << "Could not open " << options.json << std::endl;
+                }
+            }
+
+            for (auto& reporter : reporters)
+            {
+                reporter->Begin(numTests, numCategories);
+            }
+
+            // Tests finish in any order, the reporters receive them in registration order as they become available
+            std::vector<Result> results(numTests);
+            size_t next          = 0;
+            size_t numPassed     = 0;
+            size_t numPassedCat  = 0;
+            size_t qsAll         = 0;
+            size_t qsCat         = 0;
+            size_t categoryBegin = 0;
+            bool stopped         = false;
+
+            auto endCategory = [&](size_t categoryEnd) {
+                for (auto& reporter : reporters)
+                {
+                    reporter->EndCategory(all[categoryBegin]->category, categoryEnd - categoryBegin, numPassedCat, qsCat);
+                }
                 numPassed += numPassedCat;
                 qsAll += qsCat;
+                numPassedCat  = 0;
+                qsCat         = 0;
+                categoryBegin = categoryEnd;
+            };
+
+            // Held while reporting, so that the watchdog can end the reports before it aborts the run
+            std::mutex reportMutex;
+
+            auto report = [&]() {
+                std::lock_guard<std::mutex> lock(reportMutex);
+                for (; next < numTests && results[next].done; next++)
+                {
+                    FunctionInfo& test = *all[next];
+                    Result& result     = results[next];
+
+                    if (next == categoryBegin)
+                    {
+                        size_t categoryEnd = next;
+                        while (categoryEnd < numTests && all[categoryEnd]->category == test.category)
+                        {
+                            categoryEnd++;
+                        }
+
+                        // A fail-fast run may leave out part of the category, so it waits until all of it has run or the
+                        // tests that did not run have been left out
+                        if (options.failFast && !std::all_of(results.begin() + next, results.begin() + categoryEnd,
+                                                             [](const Result& result) { return result.done; }))
+                        {
+                            break;
+                        }
+                        for (auto& reporter : reporters)
+                        {
+                            reporter->BeginCategory(test.category, categoryEnd - next);
+                        }
+                    }
+
+                    if (result.measurement.samples == 0 && result.histogram.Count() != 0)
+                    {
+                        result.measurement = Measurement{ static_cast<double>(result.histogram.Percentile(0.5)), result.histogram.Mean(),
+                                                          result.histogram.Stddev(), static_cast<size_t>(result.histogram.Count()) };
+                    }
+                    else if (result.measurement.samples == 0)
+                    {
+                        result.measurement = Measurement{ result.qs * 1000.0, result.qs * 1000.0, 0, 1 };
+                    }
+                    auto previous = baseline.Find(Key(test));
+                    if (previous && !test.failed && Baseline::Regressed(*previous, result.measurement, options.regressionThreshold))
+                    {
+                        Fail(test);
+                        std::ostringstream message;
+                        message << "  Regressed by " << std::fixed << std::setprecision(1) << (result.measurement.median / previous->median - 1) * 100
+                                << "% against the baseline (" << previous->median << " ns -> " << result.measurement.median << " ns)\n";
+                        result.output += message.str();
+                    }
+
+                    qsCat += result.qs;
+                    numPassedCat += test.failed ? 0 : 1;
+                    stopped = stopped || (options.failFast && test.failed);
+                    for (auto& reporter : reporters)
+                    {
+                        reporter->Test(TestEvent{ test.category, test.name, test.file, test.failed, result.qs, result.measurement,
+                                                  options.instrument ? &result.usage : nullptr,
+                                                  result.histogram.Count() != 0 ? &result.histogram : nullptr, result.failedRuns,
+                                                  result.output });
+                    }
+
+                    if (next + 1 == numTests || all[next + 1]->category != test.category)
+                    {
+                        endCategory(next + 1);
+                    }
+                }
+            };
 
-                std::cout << (numPassedCat == tests.size() ? EVA_TEST_COLOR_GREEN : EVA_TEST_COLOR_RED) << numPassedCat << " of " << tests.size()
-                          << EVA_TEST_COLOR_STANDARD << " tests passed in " << category << " (" << qsCat / 1000 << " ms)" << std::endl
-                          << std::endl;
+            auto flush = [&]() {
+                std::lock_guard<std::mutex> lock(reportMutex);
+                for (auto& reporter : reporters)
+                {
+                    reporter->Flush();
+                }
+            };
+
+            // The tests that overran are reported as failed, each in a category of its own, so that a run that hung does not
+            // end with passing reports. Their results are left alone, as their threads are still running.
+            size_t numHung = 0;
+            auto reportHung = [&](const std::vector<Watchdog::Running>& running) {
+                for (const auto& task : running)
+                {
+                    if (!task.overrun)
+                    {
+                        continue;
+                    }
+                    FunctionInfo& test = *all[task.index];
+                    Fail(test);
+                    size_t qs = task.elapsed * 1000;
+                    Measurement measurement{ qs * 1000.0, qs * 1000.0, 0, 1 };
+                    std::string output = "  Timed out after " + std::to_string(task.timeout) + " ms\n";
+                    for (auto& reporter : reporters)
+                    {
+                        reporter->BeginCategory(test.category, 1);
+                        reporter->Test(TestEvent{ test.category, test.name, test.file, true, qs, measurement, nullptr, nullptr, 0, output });
+                        reporter->EndCategory(test.category, 1, 0, qs);
+                    }
+                    qsAll += qs;
+                    numHung++;
+                }
+            };
+
+            // Ends the reports with the tests reported so far
+            auto end = [&](size_t numSkipped) {
+                {
+                    // Parallel runs record failures in completion order
+                    std::lock_guard<std::mutex> lock(s_FailedMutex);
+                    std::sort(s_Failed.begin(), s_Failed.end(), [](const FunctionInfo* a, const FunctionInfo* b) {
+                        return a->category != b->category ? a->category < b->category : a->sequence < b->sequence;
+                    });
+                }
+                RunSummary summary{ next + numHung, numPassed, qsAll, {} };
+                summary.numSkipped = numSkipped;
+                for (auto p : s_Failed)
+                {
+                    summary.failed.emplace_back(p->category, p->name);
+                }
+                if (options.instrument)
+                {
+                    for (size_t i = 0; i < next; i++)
+                    {
+                        summary.profiles.push_back(Profile{ all[i]->category, all[i]->name, results[i].qs, results[i].usage });
+                    }
+                    Profile::Sort(summary.profiles, options.instrumentSort, options.instrumentTop);
+                    summary.sortedBy = options.instrumentSort;
+                }
+                for (auto& reporter : reporters)
+                {
+                    reporter->End(summary);
+                }
+            };
+
+            // A thread can not be stopped safely, so an overrun in process aborts the run. Isolated runs kill the test instead.
+            std::unique_ptr<Watchdog> watchdog;
+            size_t interval = 100;
+            bool watched    = false;
+            for (auto test : all)
+            {
+                if (Timeout(*test) != 0)
+                {
+                    interval = std::min<size_t>(interval, std::max<size_t>(Timeout(*test) / 10, 1));
+                    watched  = true;
+                }
             }
+            if (watched && !(EVA_TEST_HAS_FORK && options.isolate))
+            {
+                watchdog = std::make_unique<Watchdog>(options.jobs, std::chrono::milliseconds(interval),
+                                                      [&](const std::vector<Watchdog::Running>& running) {
+                                                          std::lock_guard<std::mutex> lock(reportMutex);
+                                                          if (categoryBegin < next)
+                                                          {
+                                                              endCategory(next);
+                                                          }
+                                                          reportHung(running);
+                                                          end(0);
+                                                          Hang(all, running);
+                                                      });
+            }
+            auto run = [&](size_t i) {
+                if (watchdog)
+                {
+                    watchdog->Start(Scheduler::Worker(), i, TotalTimeout(*all[i]));
+                }
+                Run(*all[i], results[i]);
+                if (watchdog)
+                {
+                    watchdog->Stop(Scheduler::Worker());
+                }
+            };
 
-            std::cout << (numPassed == numTests ? EVA_TEST_COLOR_GREEN : EVA_TEST_COLOR_RED) << numPassed << " of " << numTests
-                      << EVA_TEST_COLOR_STANDARD << " total tests passed"
-                      << " (" << qsAll / 1000 << " ms)" << std::endl;
+#if EVA_TEST_HAS_FORK
+            if (options.isolate)
+            {
+                std::vector<size_t> timeouts;
+                for (auto test : all)
+                {
+                    timeouts.push_back(TotalTimeout(*test));
+                }
+                auto shards = Partition(all, options.jobs, timings);
+                if (reordered)
+                {
+                    std::vector<size_t> ranks(order.size());
+                    for (size_t rank = 0; rank < order.size(); rank++)
+                    {
+                        ranks[order[rank]] = rank;
+                    }
+                    for (auto& shard : shards)
+                    {
+                        std::sort(shard.begin(), shard.end(), [&](size_t a, size_t b) { return ranks[a] < ranks[b]; });
+                    }
+                }
+                ProcessPool processes(
+                    std::move(shards), std::move(timeouts),
+                    [&](size_t i) {
+                        Run(*all[i], results[i]);
+                        return Encode(*all[i], results[i]);
+                    },
+                    [&](size_t i, bool crashed, const std::string& payload) {
+                        if (crashed)
+                        {
+                            results[i].crashed = true;
+                            results[i].output  = "  " + payload + "\n";
+                            Fail(*all[i]);
+                        }
+                        else
+                        {
+                            Decode(*all[i], results[i], payload);
+                        }
+                        results[i].done = true;
+                        stopped         = stopped || (options.failFast && all[i]->failed);
+                        report();
+                    });
+                while (processes.Pump())
+                {
+                    if (stopped)
+                    {
+                        processes.Stop();
+                    }
+                    flush();
+                }
+            }
+            else
+#else
+            if (options.isolate)
+            {
+                std::cout << "Process isolation is not supported on this platform" << std::endl;
+            }
+#endif
+            if (options.jobs > 1)
+            {
+                EventQueue<Result> finished;
+                Scheduler scheduler(numTests, options.jobs, [&](size_t i) {
+                    run(order[i]);
+                    if (options.failFast && all[order[i]]->failed)
+                    {
+                        scheduler.Stop();
+                    }
+                    finished.Push(&results[order[i]]);
+                });
+
+                for (size_t idle = 0; next < numTests && !stopped;)
+                {
+                    Result* result = finished.TakeAll();
+                    if (!result)
+                    {
+                        if (idle++ == 0)
+                        {
+                            flush();
+                        }
+                        std::this_thread::sleep_for(std::chrono::microseconds(std::min<size_t>(idle * 50, 1000)));
+                        continue;
+                    }
+                    for (idle = 0; result; result = result->next)
+                    {
+                        result->done = true;
+                        stopped      = stopped || (options.failFast && all[result - results.data()]->failed);
+                    }
+                    report();
+                }
+
+                if (stopped)
+                {
+                    scheduler.Stop();
+                    scheduler.Wait();
+                    for (Result* result = finished.TakeAll(); result; result = result->next)
+                    {
+                        result->done = true;
+                    }
+                }
+            }
+            else
+            {
+                // Flushed at most every 100 ms, so that slow tests show progress without every fast test writing on its own
+                auto flushed = std::chrono::steady_clock::now();
+                for (size_t i : order)
+                {
+                    if (stopped)
+                    {
+                        break;
+                    }
+                    run(i);
+                    results[i].done = true;
+                    stopped         = options.failFast && all[i]->failed;
+                    report();
+                    if (std::chrono::steady_clock::now() - flushed >= std::chrono::milliseconds(100))
+                    {
+                        flush();
+                        flushed = std::chrono::steady_clock::now();
+                    }
+                }
+            }
+
+            // The tests a fail-fast run did not get to are left out
+            size_t numSkipped = 0;
+            if (stopped)
+            {
+                size_t kept = next;
+                for (size_t i = next; i < numTests; i++)
+                {
+                    if (results[i].done)
+                    {
+                        all[kept]     = all[i];
+                        results[kept] = std::move(results[i]);
+                        kept++;
+                    }
+                }
+                numSkipped = numTests - kept;
+                numTests   = kept;
+                all.resize(kept);
+                results.resize(kept);
+                report();
+            }
+
+            SharedResource::ReleaseAll();
+
+            if (!options.failures.empty())
+            {
+                for (size_t i = 0; i < numTests; i++)
+                {
+                    failures.Set(Key(*all[i]), all[i]->failed);
+                }
+                failures.Save(options.failures);
+            }
+
+            if (!options.timings.empty())
+            {
+                for (size_t i = 0; i < numTests; i++)
+                {
+                    if (!results[i].crashed)
+                    {
+                        timings.Set(Key(*all[i]), results[i].qs);
+                    }
+                }
+                timings.Save(options.timings);
+            }
 
-            for (auto p : s_Failed)
+            if (!options.saveBaseline.empty())
             {
-                std::cout << EVA_TEST_COLOR_RED << p->category << " - " << p->name << EVA_TEST_COLOR_STANDARD << std::endl;
+                Baseline saved;
+                saved.Load(options.saveBaseline);
+                for (size_t i = 0; i < numTests; i++)
+                {
+                    if (!results[i].crashed)
+                    {
+                        saved.Set(Key(*all[i]), results[i].measurement);
+                    }
+                }
+                saved.Save(options.saveBaseline);
             }
+
+            end(numSkipped);
+            return s_Failed.empty() ? 0 : 1;
         }
 
-        static void Fail(std::string category, size_t index)
+        // Called by the thread running the test, or by the main thread once it has finished. Cold, as every assertion calls it
+        // on its failure path.
+        EVA_TEST_COLD static void Fail(FunctionInfo& test)
         {
-            s_Info[category][index].failed = true;
-            s_Failed.push_back(&s_Info[category][index]);
+            if (&test == s_Test)
+            {
+                s_RunFailed = true;
+            }
+            if (test.failed)
+            {
+                return;
+            }
+            test.failed = true;
+
+            std::lock_guard<std::mutex> lock(s_FailedMutex);
+            s_Failed.push_back(&test);
+        }
+
+        // Whether the test running on the calling thread has failed in its current run, which --repeat starts over
+        static bool CurrentRunFailed() { return s_RunFailed; }
+
+        // Fails the test running on the calling thread, for code outside of the test's own struct
+        static void FailCurrent()
+        {
+            if (s_Test)
+            {
+                Fail(*s_Test);
+            }
         }
     };
 
+    struct Registrar
+    {
+        explicit Registrar(FunctionInfo& test) { FunctionMap::Add(test); }
+    };
+
     template <typename T, typename = decltype(std::declval<std::ostream&>() << std::declval<const T&>())> 
     std::string ToString(const T& t)
     {
@@ -120,198 +1104,267 @@ namespace EVA::TEST
         return "[Not supported]";
     }
 
+    // Keeps its capacity between failures, so that reporting does not allocate once warmed up
+    class ReportBuffer : public std::streambuf
+    {
+        std::string m_Data;
+        std::ostream m_Stream{ this };
+
+      protected:
+        int_type overflow(int_type c) override
+        {
+            if (c != traits_type::eof())
+            {
+                m_Data.push_back(static_cast<char>(c));
+            }
+            return c;
+        }
+
+        std::streamsize xsputn(const char* s, std::streamsize n) override
+        {
+            m_Data.append(s, static_cast<size_t>(n));
+            return n;
+        }
+
+      public:
+        // Starts a failure message for the given line in this thread's buffer
+        static std::ostream& Begin(int line)
+        {
+            auto& buffer = Get();
+            buffer.m_Data.clear();
+            buffer.m_Stream.precision(6);
+            buffer.m_Stream << "  (" << line << ") ";
+            return buffer.m_Stream;
+        }
+
+        static void End()
+        {
+            auto& buffer = Get();
+            buffer.m_Data.push_back('\n');
+            FunctionMap::Out().write(buffer.m_Data.data(), buffer.m_Data.size());
+        }
+
+        static ReportBuffer& Get()
+        {
+            thread_local ReportBuffer buffer;
+            return buffer;
+        }
+    };
+
+    template <typename T, typename = decltype(std::declval<std::ostream&>() << std::declval<const T&>())>
+    void Write(std::ostream& out, const T& t)
+    {
+        out << t;
+    }
+
+    template <typename T, typename... Ignored>
+    void Write(std::ostream& out, const T&, const Ignored&...)
+    {
+        static_assert(sizeof...(Ignored) == 0, "Incorrect usage: only one parameter allowed");
+        out << "[Not supported]";
+    }
+
+    // The failure path of the assertions. Kept out of line and cold, so that a passing assertion is a compare and a branch.
+    template <typename... Args> EVA_TEST_COLD void Report(int line, const Args&... args)
+    {
+        auto& out = ReportBuffer::Begin(line);
+        (Write(out, args), ...);
+        ReportBuffer::End();
+    }
+
 } // namespace EVA::TEST
 
 #define RUN_ALL_TESTS EVA::TEST::FunctionMap::RunAll
 
-#define TEST(CATEGORY, NAME)                                                                                                               \
+#define TEST(CATEGORY, NAME) TEST_TIMEOUT(CATEGORY, NAME, 0)
+
+// Fails the test if it runs for longer than TIMEOUT milliseconds
+#define TEST_TIMEOUT(CATEGORY, NAME, TIMEOUT)                                                                                              \
     struct Test_##CATEGORY##NAME                                                                                                           \
     {                                                                                                                                      \
         static void Run();                                                                                                                 \
-        inline static std::string s_Category = #CATEGORY;                                                                                  \
-        inline static size_t s_Index         = 0;                                                                                          \
-        inline static bool s_Failed          = false;                                                                                      \
-        Test_##CATEGORY##NAME() { s_Index = EVA::TEST::FunctionMap::Add(&Run, #NAME, #CATEGORY, __FILE__); }                               \
-        inline static void Fail()                                                                                                          \
-        {                                                                                                                                  \
-            if (!s_Failed)                                                                                                                 \
-            {                                                                                                                              \
-                s_Failed = true;                                                                                                           \
-                EVA::TEST::FunctionMap::Fail(s_Category, s_Index);                                                                         \
-            }                                                                                                                              \
-        }                                                                                                                                  \
+        inline static EVA::TEST::FunctionInfo s_Info = { &Run, #NAME, #CATEGORY, __FILE__, (TIMEOUT) };                                    \
+        Test_##CATEGORY##NAME() { EVA::TEST::FunctionMap::Add(s_Info); }                                                                   \
+        inline static void Fail() { EVA::TEST::FunctionMap::Fail(s_Info); }                                                                \
     };                                                                                                                                     \
     inline static Test_##CATEGORY##NAME test_##CATEGORY##NAME;                                                                             \
     void Test_##CATEGORY##NAME::Run()
 
-#define EVA_TEST_PRINT(VALUE) std::cout << "  (" << __LINE__ << ") " << VALUE << std::endl
+#define EVA_TEST_PRINT(VALUE) EVA::TEST::FunctionMap::Out() << "  (" << __LINE__ << ") " << VALUE << '\n'
 
 #define EXPECT_TRUE(C)                                                                                                                     \
-    if (!(C))                                                                                                                              \
+    if (EVA_TEST_UNLIKELY(!(C)))                                                                                                           \
     {                                                                                                                                      \
         Fail();                                                                                                                            \
-        EVA_TEST_PRINT("The condition is false");                                                                                          \
+        EVA::TEST::Report(__LINE__, "The condition is false");                                                                             \
     }
 #define EXPECT_FALSE(C)                                                                                                                    \
-    if ((C))                                                                                                                               \
+    if (EVA_TEST_UNLIKELY((C)))                                                                                                            \
     {                                                                                                                                      \
         Fail();                                                                                                                            \
-        EVA_TEST_PRINT("The condition is true");                                                                                           \
+        EVA::TEST::Report(__LINE__, "The condition is true");                                                                              \
     }
 
 #define EXPECT_EQ(A, B)                                                                                                                    \
-    if (!((A) == (B)))                                                                                                                     \
+    if (EVA_TEST_UNLIKELY(!((A) == (B))))                                                                                                  \
     {                                                                                                                                      \
         Fail();                                                                                                                            \
-        EVA_TEST_PRINT("Expected " << EVA::TEST::ToString((B)) << ", got " << EVA::TEST::ToString((A)));                                   \
+        EVA::TEST::Report(__LINE__, "Expected ", (B), ", got ", (A));                                                                      \
     }
 #define EXPECT_NE(A, B)                                                                                                                    \
-    if (!((A) != (B)))                                                                                                                     \
+    if (EVA_TEST_UNLIKELY(!((A) != (B))))                                                                                                  \
     {                                                                                                                                      \
         Fail();                                                                                                                            \
-        EVA_TEST_PRINT("Expected the values to not be equal: " << EVA::TEST::ToString((A)));                                               \
+        EVA::TEST::Report(__LINE__, "Expected the values to not be equal: ", (A));                                                         \
     }
 
 #define EXPECT_LT(A, B)                                                                                                                    \
-    if (!((A) < (B)))                                                                                                                      \
+    if (EVA_TEST_UNLIKELY(!((A) < (B))))                                                                                                   \
     {                                                                                                                                      \
         Fail();                                                                                                                            \
-        EVA_TEST_PRINT("Expected " << EVA::TEST::ToString((A)) << " < " << EVA::TEST::ToString((B)));                                      \
+        EVA::TEST::Report(__LINE__, "Expected ", (A), " < ", (B));                                                                         \
     }
 #define EXPECT_LE(A, B)                                                                                                                    \
-    if (!((A) <= (B)))                                                                                                                     \
+    if (EVA_TEST_UNLIKELY(!((A) <= (B))))                                                                                                  \
     {                                                                                                                                      \
         Fail();                                                                                                                            \
-        EVA_TEST_PRINT("Expected " << EVA::TEST::ToString((A)) << " <= " << EVA::TEST::ToString((B)));                                     \
+        EVA::TEST::Report(__LINE__, "Expected ", (A), " <= ", (B));                                                                        \
     }
 
 #define EXPECT_GT(A, B)                                                                                                                    \
-    if (!((A) > (B)))                                                                                                                      \
+    if (EVA_TEST_UNLIKELY(!((A) > (B))))                                                                                                   \
     {                                                                                                                                      \
         Fail();                                                                                                                            \
-        EVA_TEST_PRINT("Expected " << EVA::TEST::ToString((A)) << " == " << EVA::TEST::ToString((B)));                                     \
+        EVA::TEST::Report(__LINE__, "Expected ", (A), " > ", (B));                                                                         \
     }
 #define EXPECT_GE(A, B)                                                                                                                    \
-    if (!((A) >= (B)))                                                                                                                     \
+    if (EVA_TEST_UNLIKELY(!((A) >= (B))))                                                                                                  \
     {                                                                                                                                      \
         Fail();                                                                                                                            \
-        EVA_TEST_PRINT("Expected " << EVA::TEST::ToString((A)) << " >= " << EVA::TEST::ToString((B)));                                     \
+        EVA::TEST::Report(__LINE__, "Expected ", (A), " >= ", (B));                                                                        \
     }
 
 #define EXPECT_STREQ(A, B)                                                                                                                 \
-    if (strcmp((A), (B)) != 0)                                                                                                             \
+    if (EVA_TEST_UNLIKELY(strcmp((A), (B)) != 0))                                                                                          \
     {                                                                                                                                      \
         Fail();                                                                                                                            \
-        EVA_TEST_PRINT("Expected \"" << EVA::TEST::ToString((B)) << "\", got \"" << EVA::TEST::ToString((A)) << '"');                      \
+        EVA::TEST::Report(__LINE__, "Expected \"", (B), "\", got \"", (A), '"');                                                           \
     }
 #define EXPECT_STRNQ(A, B)                                                                                                                 \
-    if (strcmp((A), (B)) == 0)                                                                                                             \
+    if (EVA_TEST_UNLIKELY(strcmp((A), (B)) == 0))                                                                                          \
     {                                                                                                                                      \
         Fail();                                                                                                                            \
-        EVA_TEST_PRINT("Expected the values to not be equal: \"" << EVA::TEST::ToString((A)) << '"');                                      \
+        EVA::TEST::Report(__LINE__, "Expected the values to not be equal: \"", (A), '"');                                                  \
     }
 
 #define EXPECT_MEMEQ(A, B, LENGTH)                                                                                                         \
-    if (memcmp((A), (B), (LENGTH)) != 0)                                                                                                   \
+    if (EVA_TEST_UNLIKELY(memcmp((A), (B), (LENGTH)) != 0))                                                                                \
     {                                                                                                                                      \
         Fail();                                                                                                                            \
-        EVA_TEST_PRINT("Expected the values to be equal");                                                                                 \
+        EVA::TEST::Report(__LINE__, "Expected the values to be equal");                                                                    \
     }
 #define EXPECT_MEMNQ(A, B, LENGTH)                                                                                                         \
-    if (memcmp((A), (B), (LENGTH)) == 0)                                                                                                   \
+    if (EVA_TEST_UNLIKELY(memcmp((A), (B), (LENGTH)) == 0))                                                                                \
     {                                                                                                                                      \
         Fail();                                                                                                                            \
-        EVA_TEST_PRINT("Expected the values to not be equal");                                                                             \
+        EVA::TEST::Report(__LINE__, "Expected the values to not be equal");                                                                \
     }
 
 
 #define ASSERT_TRUE(C)                                                                                                                     \
-    if (!(C))                                                                                                                              \
+    if (EVA_TEST_UNLIKELY(!(C)))                                                                                                           \
     {                                                                                                                                      \
         Fail();                                                                                                                            \
-        EVA_TEST_PRINT("Assertion failed. The condition is false");                                                                        \
+        EVA::TEST::Report(__LINE__, "Assertion failed. The condition is false");                                                           \
         return;                                                                                                                            \
     }
 #define ASSERT_FALSE(C)                                                                                                                    \
-    if ((C))                                                                                                                               \
+    if (EVA_TEST_UNLIKELY((C)))                                                                                                            \
     {                                                                                                                                      \
         Fail();                                                                                                                            \
-        EVA_TEST_PRINT("Assertion failed. The condition is true");                                                                         \
+        EVA::TEST::Report(__LINE__, "Assertion failed. The condition is true");                                                            \
         return;                                                                                                                            \
     }
 
 #define ASSERT_EQ(A, B)                                                                                                                    \
-    if (!((A) == (B)))                                                                                                                     \
+    if (EVA_TEST_UNLIKELY(!((A) == (B))))                                                                                                  \
     {                                                                                                                                      \
         Fail();                                                                                                                            \
-        EVA_TEST_PRINT("Assertion failed. Expected " << EVA::TEST::ToString((B)) << ", got " << EVA::TEST::ToString((A)));                 \
+        EVA::TEST::Report(__LINE__, "Assertion failed. Expected ", (B), ", got ", (A));                                                    \
         return;                                                                                                                            \
     }
 #define ASSERT_NE(A, B)                                                                                                                    \
-    if (!((A) != (B)))                                                                                                                     \
+    if (EVA_TEST_UNLIKELY(!((A) != (B))))                                                                                                  \
     {                                                                                                                                      \
         Fail();                                                                                                                            \
-        EVA_TEST_PRINT("Assertion failed. Expected the values to not be equal: " << EVA::TEST::ToString((A)));                             \
+        EVA::TEST::Report(__LINE__, "Assertion failed. Expected the values to not be equal: ", (A));                                       \
         return;                                                                                                                            \
     }
 
 #define ASSERT_LT(A, B)                                                                                                                    \
-    if (!((A) < (B)))                                                                                                                      \
+    if (EVA_TEST_UNLIKELY(!((A) < (B))))                                                                                                   \
     {                                                                                                                                      \
         Fail();                                                                                                                            \
-        EVA_TEST_PRINT("Assertion failed. Expected " << EVA::TEST::ToString((A)) << " < " << EVA::TEST::ToString((B)));                    \
+        EVA::TEST::Report(__LINE__, "Assertion failed. Expected ", (A), " < ", (B));                                                       \
         return;                                                                                                                            \
     }
 #define ASSERT_LE(A, B)                                                                                                                    \
-    if (!((A) <= (B)))                                                                                                                     \
+    if (EVA_TEST_UNLIKELY(!((A) <= (B))))                                                                                                  \
     {                                                                                                                                      \
         Fail();                                                                                                                            \
-        EVA_TEST_PRINT("Assertion failed. Expected " << EVA::TEST::ToString((A)) << " <= " << EVA::TEST::ToString((B)));                   \
+        EVA::TEST::Report(__LINE__, "Assertion failed. Expected ", (A), " <= ", (B));                                                      \
         return;                                                                                                                            \
     }
 
 #define ASSERT_GT(A, B)                                                                                                                    \
-    if (!((A) > (B)))                                                                                                                      \
+    if (EVA_TEST_UNLIKELY(!((A) > (B))))                                                                                                   \
     {                                                                                                                                      \
         Fail();                                                                                                                            \
-        EVA_TEST_PRINT("Assertion failed. Expected " << EVA::TEST::ToString((A)) << " > " << EVA::TEST::ToString((B)));                    \
+        EVA::TEST::Report(__LINE__, "Assertion failed. Expected ", (A), " > ", (B));                                                       \
         return;                                                                                                                            \
     }
 #define ASSERT_GE(A, B)                                                                                                                    \
-    if (!((A) >= (B)))                                                                                                                     \
+    if (EVA_TEST_UNLIKELY(!((A) >= (B))))                                                                                                  \
     {                                                                                                                                      \
         Fail();                                                                                                                            \
-        EVA_TEST_PRINT("Assertion failed. Expected " << EVA::TEST::ToString((A)) << " >= " << EVA::TEST::ToString((B)));                   \
+        EVA::TEST::Report(__LINE__, "Assertion failed. Expected ", (A), " >= ", (B));                                                      \
         return;                                                                                                                            \
     }
 
 
 #define ASSERT_STREQ(A, B)                                                                                                                 \
-    if (strcmp((A), (B)) != 0)                                                                                                             \
+    if (EVA_TEST_UNLIKELY(strcmp((A), (B)) != 0))                                                                                          \
     {                                                                                                                                      \
         Fail();                                                                                                                            \
-        EVA_TEST_PRINT("Assertion failed. Expected \"" << EVA::TEST::ToString((B)) << "\", got \"" << EVA::TEST::ToString((A)) << '"');    \
+        EVA::TEST::Report(__LINE__, "Assertion failed. Expected \"", (B), "\", got \"", (A), '"');                                         \
         return;                                                                                                                            \
     }
 #define ASSERT_STRNQ(A, B)                                                                                                                 \
-    if (strcmp((A), (B)) == 0)                                                                                                             \
+    if (EVA_TEST_UNLIKELY(strcmp((A), (B)) == 0))                                                                                          \
     {                                                                                                                                      \
         Fail();                                                                                                                            \
-        EVA_TEST_PRINT("Assertion failed. Expected the values to not be equal: \"" << EVA::TEST::ToString((A)) << '"');                    \
+        EVA::TEST::Report(__LINE__, "Assertion failed. Expected the values to not be equal: \"", (A), '"');                                \
         return;                                                                                                                            \
     }
 
 #define ASSERT_MEMEQ(A, B, LENGTH)                                                                                                         \
-    if (memcmp((A), (B), (LENGTH)) != 0)                                                                                                   \
+    if (EVA_TEST_UNLIKELY(memcmp((A), (B), (LENGTH)) != 0))                                                                                \
     {                                                                                                                                      \
         Fail();                                                                                                                            \
-        EVA_TEST_PRINT("Assertion failed. Expected the values to be equal");                                                               \
+        EVA::TEST::Report(__LINE__, "Assertion failed. Expected the values to be equal");                                                  \
         return;                                                                                                                            \
     }
 #define ASSERT_MEMNQ(A, B, LENGTH)                                                                                                         \
-    if (memcmp((A), (B), (LENGTH)) == 0)                                                                                                   \
+    if (EVA_TEST_UNLIKELY(memcmp((A), (B), (LENGTH)) == 0))                                                                                \
     {                                                                                                                                      \
         Fail();                                                                                                                            \
-        EVA_TEST_PRINT("Assertion failed. Expected the values to not be equal");                                                           \
+        EVA::TEST::Report(__LINE__, "Assertion failed. Expected the values to not be equal");                                              \
         return;                                                                                                                            \
     }
+
+#include "Allocation.hpp"
+#include "Benchmark.hpp"
+#include "Fixture.hpp"
+#include "Parameterized.hpp"
+#include "Property.hpp"
+#include "Range.hpp"
@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+
+namespace EVA::TEST
+{
+    // Per-test durations in microseconds from previous runs, keyed by "category::name". Stored as text, one "qs key" pair
+    // per line.
+    class Timings
+    {
+        std::map<std::string, uint64_t> m_Qs;
+
+      public:
+        bool Load(const std::string& path)
+        {
+            std::ifstream file(path);
+            if (!file)
+            {
+                return false;
+            }
+            uint64_t qs;
+            std::string key;
+            while (file >> qs >> key)
+            {
+                m_Qs[key] = qs;
+            }
+            return true;
+        }
+
+        bool Save(const std::string& path) const
+        {
+            std::ofstream file(path, std::ios::trunc);
+            for (const auto& [key, qs] : m_Qs)
+            {
+                file << qs << ' ' << key << '\n';
+            }
+            return static_cast<bool>(file);
+        }
+
+        const uint64_t* Find(const std::string& key) const
+        {
+            auto it = m_Qs.find(key);
+            return it == m_Qs.end() ? nullptr : &it->second;
+        }
+
+        void Set(const std::string& key, uint64_t qs) { m_Qs[key] = qs; }
+
+        bool Empty() const { return m_Qs.empty(); }
+
+        uint64_t Mean() const
+        {
+            if (m_Qs.empty())
+            {
+                return 0;
+            }
+            uint64_t sum = 0;
+            for (const auto& [key, qs] : m_Qs)
+            {
+                sum += qs;
+            }
+            return sum / m_Qs.size();
+        }
+    };
+} // namespace EVA::TEST
@@ -0,0 +1,124 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace EVA::TEST
+{
+    // Watches the tasks running on a set of worker slots from a thread of its own, and hands the running tasks to the
+    // callback whenever one of them overruns its timeout. Each overrun is reported once.
+    class Watchdog
+    {
+      public:
+        struct Running
+        {
+            size_t index;
+            size_t elapsed;
+            size_t timeout;
+            bool overrun;
+        };
+
+        using Hang = std::function<void(const std::vector<Running>& running)>;
+
+      private:
+        using Clock = std::chrono::steady_clock;
+
+        // The sequence is odd while a task runs. The task fields are only written while it is even, so a reader that
+        // sees the same odd sequence before and after reading them has a consistent copy.
+        struct alignas(64) Slot
+        {
+            std::atomic<uint64_t> sequence{ 0 };
+            std::atomic<size_t> index{ 0 };
+            std::atomic<size_t> timeout{ 0 };
+            std::atomic<int64_t> start{ 0 };
+        };
+
+        std::vector<Slot> m_Slots;
+        Hang m_Hang;
+        std::chrono::milliseconds m_Interval;
+        bool m_Stop = false;
+        std::mutex m_Mutex;
+        std::condition_variable m_Wake;
+        std::thread m_Thread;
+
+        static int64_t Now() { return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now().time_since_epoch()).count(); }
+
+        void Watch()
+        {
+            std::vector<uint64_t> reported(m_Slots.size(), 0);
+            std::vector<Running> running;
+
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            while (!m_Wake.wait_for(lock, m_Interval, [this] { return m_Stop; }))
+            {
+                running.clear();
+                bool overrun = false;
+                int64_t now  = Now();
+                for (size_t i = 0; i < m_Slots.size(); i++)
+                {
+                    auto& slot        = m_Slots[i];
+                    uint64_t sequence = slot.sequence.load();
+                    if (sequence % 2 == 0)
+                    {
+                        continue;
+                    }
+                    Running task{ slot.index.load(), static_cast<size_t>(now - slot.start.load()), slot.timeout.load(), false };
+                    if (slot.sequence.load() != sequence)
+                    {
+                        continue;
+                    }
+
+                    if (task.timeout != 0 && task.elapsed >= task.timeout && reported[i] != sequence)
+                    {
+                        reported[i]  = sequence;
+                        task.overrun = true;
+                        overrun      = true;
+                    }
+                    running.push_back(task);
+                }
+
+                if (overrun)
+                {
+                    m_Hang(running);
+                }
+            }
+        }
+
+      public:
+        Watchdog(size_t slots, std::chrono::milliseconds interval, Hang hang)
+            : m_Slots(slots == 0 ? 1 : slots), m_Hang(std::move(hang)), m_Interval(interval)
+        {
+            m_Thread = std::thread(&Watchdog::Watch, this);
+        }
+
+        ~Watchdog()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Stop = true;
+            }
+            m_Wake.notify_one();
+            m_Thread.join();
+        }
+
+        Watchdog(const Watchdog&) = delete;
+        Watchdog& operator=(const Watchdog&) = delete;
+
+        // Only the slot's own worker may start and stop its tasks. A timeout of 0 never overruns.
+        void Start(size_t slot, size_t index, size_t timeout)
+        {
+            auto& s = m_Slots[slot];
+            s.index.store(index);
+            s.timeout.store(timeout);
+            s.start.store(Now());
+            s.sequence.fetch_add(1);
+        }
+
+        void Stop(size_t slot) { m_Slots[slot].sequence.fetch_add(1); }
+    };
+} // namespace EVA::TEST
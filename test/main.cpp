@@ -1,10 +1,19 @@
 #include "EVA/Test/Test.hpp"
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <csignal>
+#include <cstdio>
 #include <iostream>
+#include <numeric>
+#include <thread>
 
-int main()
+int main(int argc, char** argv)
 {
-    RUN_ALL_TESTS();
-    return 0;
+    return RUN_ALL_TESTS(argc, argv);
 }
 
 TEST(ShouldPass, All)
@@ -59,6 +68,506 @@ TEST(ShouldPass, All)
     ASSERT_MEMNQ(&a, &c, sizeof(S));
 }
 
+TEST(ShouldPass, Scheduler)
+{
+    std::vector<std::atomic<int>> counts(10000);
+    {
+        EVA::TEST::Scheduler scheduler(counts.size(), 8, [&](size_t i) { counts[i]++; });
+    }
+
+    for (auto& count : counts)
+    {
+        ASSERT_EQ(count.load(), 1);
+    }
+}
+
+TEST(ShouldPass, SchedulerStop)
+{
+    constexpr size_t jobs     = 4;
+    std::atomic<size_t> count = 0;
+    {
+        // Every task waits for the scheduler to be published, and the ones past the stop point wait for it to be stopped,
+        // so each other worker runs at most one more task
+        std::atomic<EVA::TEST::Scheduler*> published = nullptr;
+        std::atomic<bool> stopped                    = false;
+        EVA::TEST::Scheduler scheduler(10000, jobs, [&](size_t) {
+            while (!published.load())
+            {
+                std::this_thread::yield();
+            }
+            size_t n = count++;
+            if (n == 100)
+            {
+                published.load()->Stop();
+                stopped = true;
+            }
+            while (n > 100 && !stopped.load())
+            {
+                std::this_thread::yield();
+            }
+        });
+        published = &scheduler;
+    }
+    EXPECT_LE(count.load(), 100 + jobs);
+}
+
+TEST(ShouldPass, Failures)
+{
+    std::string path = "EVA_Test_Failures.txt";
+    {
+        EVA::TEST::Failures failures;
+        failures.Set("A::B", true);
+        failures.Set("A::C", true);
+        failures.Set("A::C", false);
+        ASSERT_TRUE(failures.Save(path));
+    }
+
+    EVA::TEST::Failures failures;
+    ASSERT_TRUE(failures.Load(path));
+    EXPECT_TRUE(failures.Contains("A::B"));
+    EXPECT_FALSE(failures.Contains("A::C"));
+    std::remove(path.c_str());
+}
+
+TEST(ShouldPass, Histogram)
+{
+    EVA::TEST::Histogram histogram;
+    for (uint64_t ns = 1; ns <= 100000; ns++)
+    {
+        histogram.Record(ns);
+    }
+    EXPECT_EQ(histogram.Count(), 100000);
+    EXPECT_EQ(histogram.Min(), 1);
+    EXPECT_EQ(histogram.Max(), 100000);
+    EXPECT_EQ(histogram.Percentile(0.00001), 1);
+    EXPECT_EQ(histogram.Percentile(1.0), 100000);
+    EXPECT_LT(std::abs(histogram.Percentile(0.5) / 50000.0 - 1), 0.04);
+    EXPECT_LT(std::abs(histogram.Percentile(0.99) / 99000.0 - 1), 0.04);
+    EXPECT_LT(std::abs(histogram.Percentile(0.999) / 99900.0 - 1), 0.04);
+    EXPECT_LT(std::abs(histogram.Mean() - 50000.5), 1e-6);
+    EXPECT_LT(std::abs(histogram.Stddev() - 28867.66), 0.01);
+
+    std::string payload;
+    histogram.Encode(payload);
+    EVA::TEST::Histogram decoded;
+    size_t offset = 0;
+    decoded.Decode(payload, offset);
+    EXPECT_EQ(offset, payload.size());
+    EXPECT_EQ(decoded.Count(), histogram.Count());
+    EXPECT_EQ(decoded.Percentile(0.99), histogram.Percentile(0.99));
+    EXPECT_EQ(decoded.Mean(), histogram.Mean());
+    EXPECT_EQ(decoded.Stddev(), histogram.Stddev());
+}
+
+TEST(ShouldPass, Partition)
+{
+    std::vector<EVA::TEST::FunctionInfo> tests;
+    for (const char* name : { "A", "B", "C", "D", "E", "F" })
+    {
+        tests.push_back(EVA::TEST::FunctionInfo{ nullptr, name, "Partition", __FILE__ });
+    }
+    std::vector<EVA::TEST::FunctionInfo*> pointers;
+    for (auto& test : tests)
+    {
+        pointers.push_back(&test);
+    }
+
+    EVA::TEST::Timings timings;
+    timings.Set("Partition::A", 60);
+    timings.Set("Partition::B", 10);
+    timings.Set("Partition::C", 30);
+    timings.Set("Partition::D", 30);
+    timings.Set("Partition::E", 10);
+    timings.Set("Partition::F", 20);
+
+    auto shards = EVA::TEST::FunctionMap::Partition(pointers, 2, timings);
+    ASSERT_EQ(shards.size(), 2);
+    EXPECT_EQ(shards[0], std::vector<size_t>({ 0, 5 }));
+    EXPECT_EQ(shards[1], std::vector<size_t>({ 1, 2, 3, 4 }));
+}
+
+TEST(ShouldPass, BenchmarkStats)
+{
+    std::vector<double> samples;
+    for (int i = 100; i >= 1; i--)
+    {
+        samples.push_back(i);
+    }
+
+    auto stats = EVA::TEST::Benchmark::Summarize(samples, 10);
+    EXPECT_EQ(stats.iterations, 10);
+    EXPECT_EQ(stats.samples, 100);
+    EXPECT_EQ(stats.min, 1.0);
+    EXPECT_EQ(stats.median, 50.5);
+    EXPECT_EQ(stats.p99, 99.0);
+    EXPECT_EQ(stats.mean, 50.5);
+    EXPECT_LT(std::abs(stats.stddev - 29.0115), 0.0001);
+}
+
+TEST(ShouldPass, Baseline)
+{
+    EVA::TEST::Measurement baseline{ 100, 100, 2, 20 };
+
+    EXPECT_FALSE(EVA::TEST::Baseline::Regressed(baseline, { 105, 105, 2, 20 }, 0.1));
+    EXPECT_TRUE(EVA::TEST::Baseline::Regressed(baseline, { 120, 120, 2, 20 }, 0.1));
+    EXPECT_FALSE(EVA::TEST::Baseline::Regressed(baseline, { 120, 120, 80, 20 }, 0.1));
+    EXPECT_FALSE(EVA::TEST::Baseline::Regressed({ 1e6, 1e6, 0, 1 }, { 1.5e6, 1.5e6, 0, 1 }, 0.1));
+    EXPECT_TRUE(EVA::TEST::Baseline::Regressed({ 1e6, 1e6, 0, 1 }, { 2.5e6, 2.5e6, 0, 1 }, 0.1));
+}
+
+BENCHMARK(ShouldPass, Accumulate)
+{
+    std::vector<int> values(1024);
+    std::iota(values.begin(), values.end(), 0);
+
+    for (auto _ : state)
+    {
+        EVA::TEST::DoNotOptimize(values.data());
+        int sum = std::accumulate(values.begin(), values.end(), 0);
+        EVA::TEST::DoNotOptimize(sum);
+        EVA::TEST::ClobberMemory();
+    }
+    EXPECT_EQ(std::accumulate(values.begin(), values.end(), 0), 1023 * 1024 / 2);
+}
+
+BENCHMARK(ShouldPass, ExpectEq)
+{
+    int values[64];
+    std::iota(std::begin(values), std::end(values), 0);
+
+    for (auto i : state.Counted())
+    {
+        EVA::TEST::DoNotOptimize(values);
+        EXPECT_EQ(values[i & 63], static_cast<int>(i & 63));
+    }
+}
+
+TEST(ShouldPass, Range)
+{
+    std::vector<float> a(1001);
+    std::iota(a.begin(), a.end(), 0.0f);
+    std::vector<float> b = a;
+    std::vector<int> c(5000, 7);
+    std::array<int, 3> d = { 1, 2, 3 };
+    int e[]              = { 1, 2, 3 };
+
+    EXPECT_RANGE_EQ(a, b);
+    EXPECT_RANGE_EQ(c, std::vector<int>(5000, 7));
+    EXPECT_RANGE_EQ(d, e);
+
+    b[1000] = std::nextafter(b[1000], 2000.0f);
+    EXPECT_NEAR_ALL(a, b, 0.001f);
+    EXPECT_NEAR_ALL(a, b, EVA::TEST::Ulps{ 1 });
+    EXPECT_NEAR_ALL(std::vector<double>({ 0.0, 1.0 }), std::vector<double>({ -0.0, 1.0 + 1e-9 }), 1e-8);
+    EXPECT_NEAR_ALL(std::vector<double>({ 0.0, 1.0 }), std::vector<double>({ -0.0, 1.0 }), EVA::TEST::Ulps{ 0 });
+
+    ASSERT_RANGE_EQ(d, e);
+    ASSERT_NEAR_ALL(a, b, EVA::TEST::Ulps{ 1 });
+}
+
+TEST(ShouldPass, RangeKernels)
+{
+    std::vector<float> a(100, 1.0f);
+    std::vector<double> b(100, 1.0);
+    for (size_t i = 0; i < 100; i++)
+    {
+        std::vector<float> x = a;
+        std::vector<double> y = b;
+        x[i]                  = std::numeric_limits<float>::quiet_NaN();
+        y[i]                  = 1.5;
+
+        EXPECT_EQ(EVA::TEST::FindMismatch(a.data(), x.data(), 100, 0), i);
+        EXPECT_EQ(EVA::TEST::FindMismatch(b.data(), y.data(), 100, 0), i);
+        EXPECT_EQ(EVA::TEST::FindNotNear(a.data(), x.data(), 100, 0, 10.0f), i);
+        EXPECT_EQ(EVA::TEST::FindNotNear(a.data(), x.data(), 100, 0, EVA::TEST::Ulps{ 10 }), i);
+        EXPECT_EQ(EVA::TEST::FindNotNear(b.data(), y.data(), 100, 0, 0.25), i);
+        EXPECT_EQ(EVA::TEST::FindNotNear(b.data(), y.data(), 100, 0, 0.5), 100);
+    }
+
+    EXPECT_EQ(EVA::TEST::UlpDistance(-0.0f, 0.0f), 0);
+    EXPECT_EQ(EVA::TEST::UlpDistance(-std::numeric_limits<float>::denorm_min(), std::numeric_limits<float>::denorm_min()), 2);
+    EXPECT_EQ(EVA::TEST::UlpDistance(1.0, std::nextafter(1.0, 2.0)), 1);
+}
+
+BENCHMARK(ShouldPass, RangeEq)
+{
+    std::vector<float> a(1 << 20, 1.0f);
+    std::vector<float> b = a;
+
+    for (auto _ : state)
+    {
+        EVA::TEST::DoNotOptimize(a.data());
+        EXPECT_RANGE_EQ(a, b);
+    }
+}
+
+TEST(ShouldPass, Reporter)
+{
+    EXPECT_EQ(EVA::TEST::EscapeXml("<a b=\"c\"> & 'd'\x01"), "&lt;a b=&quot;c&quot;&gt; &amp; &apos;d&apos;");
+    EXPECT_EQ(EVA::TEST::EscapeJson("\"a\"\\\n\x01"), "\\\"a\\\"\\\\\\n\\u0001");
+
+    struct Event
+    {
+        size_t value;
+        Event* next;
+    };
+    std::vector<Event> events(1000);
+    EVA::TEST::EventQueue<Event> queue;
+    {
+        EVA::TEST::Scheduler scheduler(events.size(), 4, [&](size_t i) {
+            events[i].value = i;
+            queue.Push(&events[i]);
+        });
+    }
+
+    size_t count = 0, sum = 0;
+    for (Event* event = queue.TakeAll(); event; event = event->next)
+    {
+        count++;
+        sum += event->value;
+    }
+    EXPECT_EQ(count, 1000);
+    EXPECT_EQ(sum, 999 * 1000 / 2);
+    EXPECT_TRUE(queue.TakeAll() == nullptr);
+}
+
+TEST(ShouldPass, Filter)
+{
+    EXPECT_TRUE(EVA::TEST::Glob("A*::*B?", "AB::CBD"));
+    EXPECT_TRUE(EVA::TEST::Glob("*", ""));
+    EXPECT_FALSE(EVA::TEST::Glob("A*C", "ABCD"));
+
+    std::vector<std::string> keys = { "A::X", "A::Y", "B::X", "B::Y", "C::Z" };
+    auto select                   = [&](const std::string& filter) {
+        std::vector<size_t> selected;
+        EVA::TEST::Filter(filter).Select(keys, [&](size_t i) { selected.push_back(i); });
+        return selected;
+    };
+
+    EXPECT_EQ(select(""), std::vector<size_t>({ 0, 1, 2, 3, 4 }));
+    EXPECT_EQ(select("A::*"), std::vector<size_t>({ 0, 1 }));
+    EXPECT_EQ(select("B::Y:C::Z"), std::vector<size_t>({ 3, 4 }));
+    EXPECT_EQ(select("*::X"), std::vector<size_t>({ 0, 2 }));
+    EXPECT_EQ(select("-*::X"), std::vector<size_t>({ 1, 3, 4 }));
+    EXPECT_EQ(select("A::*:B::*-*::Y"), std::vector<size_t>({ 0, 2 }));
+    EXPECT_TRUE(EVA::TEST::Filter("A::*-A::Y").Matches("A::X"));
+    EXPECT_FALSE(EVA::TEST::Filter("A::*-A::Y").Matches("A::Y"));
+}
+
+TEST_TIMEOUT(ShouldPass, Watchdog, 5000)
+{
+    std::mutex mutex;
+    std::vector<EVA::TEST::Watchdog::Running> hung;
+    {
+        EVA::TEST::Watchdog watchdog(2, std::chrono::milliseconds(5), [&](const std::vector<EVA::TEST::Watchdog::Running>& running) {
+            std::lock_guard<std::mutex> lock(mutex);
+            hung = running;
+        });
+        watchdog.Start(0, 7, 20);
+        watchdog.Start(1, 8, 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        watchdog.Stop(0);
+        watchdog.Stop(1);
+    }
+
+    ASSERT_EQ(hung.size(), 2);
+    EXPECT_EQ(hung[0].index, 7);
+    EXPECT_TRUE(hung[0].overrun);
+    EXPECT_GE(hung[0].elapsed, 20);
+    EXPECT_EQ(hung[1].index, 8);
+    EXPECT_FALSE(hung[1].overrun);
+}
+
+TEST(ShouldPass, Allocations)
+{
+    struct alignas(64) Line
+    {
+        char data[64];
+    };
+
+    auto start = EVA::TEST::Usage::Sample();
+    {
+        std::vector<int> values(250);
+        auto line = std::make_unique<Line>();
+        EVA::TEST::DoNotOptimize(values.data());
+        EVA::TEST::DoNotOptimize(line.get());
+    }
+    auto usage = EVA::TEST::Usage::Sample().Since(start);
+    EXPECT_EQ(usage.allocations, 2);
+    EXPECT_EQ(usage.bytes, 250 * sizeof(int) + sizeof(Line));
+
+    std::vector<EVA::TEST::Profile> profiles;
+    for (uint64_t allocations : { 3, 9, 1, 5 })
+    {
+        profiles.push_back(EVA::TEST::Profile{ "Profile", "Test", 10 - allocations, { 0, 0, allocations, 0, 0 } });
+    }
+    EVA::TEST::Profile::Sort(profiles, "allocations", 2);
+    ASSERT_EQ(profiles.size(), 2);
+    EXPECT_EQ(profiles[0].usage.allocations, 9);
+    EXPECT_EQ(profiles[1].usage.allocations, 5);
+    EVA::TEST::Profile::Sort(profiles, "wall", 5);
+    EXPECT_EQ(profiles[0].qs, 5);
+}
+
+TEST(ShouldPass, NoAlloc)
+{
+    std::vector<int> values;
+    values.reserve(16);
+    EXPECT_NO_ALLOC
+    {
+        for (int i = 0; i < 16; i++)
+        {
+            values.push_back(i);
+        }
+    }
+    ASSERT_MAX_ALLOCS(3)
+    {
+        auto first  = std::make_unique<int>(1);
+        auto second = std::make_unique<int>(2);
+        EVA::TEST::DoNotOptimize(first.get());
+        EVA::TEST::DoNotOptimize(second.get());
+        EXPECT_MAX_ALLOCS(1)
+        {
+            auto third = std::make_unique<int>(3);
+            EVA::TEST::DoNotOptimize(third.get());
+        }
+    }
+    EXPECT_EQ(values.size(), 16);
+}
+
+TEST_P(ShouldPass, Sizes, EVA::TEST::Values<size_t>(1, 16, 4096))
+{
+    std::vector<size_t> values(GetParam(), 1);
+    EXPECT_EQ(std::accumulate(values.begin(), values.end(), size_t(0)), GetParam());
+}
+
+TYPED_TEST(ShouldPass, Kernel, float, double, int)
+{
+    std::vector<TypeParam> values(100, TypeParam(1));
+    EXPECT_RANGE_EQ(values, std::vector<TypeParam>(100, TypeParam(1)));
+    EXPECT_EQ(std::accumulate(values.begin(), values.end(), TypeParam(0)), TypeParam(100));
+}
+
+TYPED_TEST(ShouldPass, Pair, std::pair<int, int>, int) { EXPECT_EQ(sizeof(TypeParam) % sizeof(int), 0); }
+
+TYPED_BENCHMARK(ShouldPass, Sum, float, int)
+{
+    std::vector<TypeParam> values(1024, TypeParam(1));
+    for (auto _ : state)
+    {
+        EVA::TEST::DoNotOptimize(std::accumulate(values.begin(), values.end(), TypeParam(0)));
+    }
+}
+
+TEST(ShouldPass, InstanceNames)
+{
+    EXPECT_EQ(EVA::TEST::ListItem("std::pair<int, int>, float", 0), "std::pair<int, int>");
+    EXPECT_EQ(EVA::TEST::ListItem("std::pair<int, int>, float", 1), "float");
+    constexpr auto sequence = EVA::TEST::Sequence<int, 2, 11, 3>();
+    EXPECT_EQ(sequence.size(), 3);
+    EXPECT_EQ(sequence[2], 8);
+
+    EXPECT_EQ(TestP_ShouldPassSizes<2>::s_Info.name, "Sizes/2");
+    EXPECT_EQ(TestP_ShouldPassSizes<2>::GetParam(), 4096);
+    EXPECT_EQ(TypedTest_ShouldPassKernel<1>::s_Info.name, "Kernel<double>");
+    EXPECT_EQ(TypedBenchmark_ShouldPassSum<1>::s_Info.name, "Sum<int>");
+    EXPECT_EQ(TypedTest_ShouldPassPair<0>::s_Info.name, "Pair<std::pair<int,int>>");
+}
+
+struct Dataset : EVA::TEST::Fixture
+{
+    inline static std::atomic<int> s_Builds{ 0 };
+    inline static EVA::TEST::Shared<std::vector<int>> s_Values{ [] {
+        s_Builds++;
+        std::vector<int> values(1000);
+        std::iota(values.begin(), values.end(), 0);
+        return values;
+    } };
+
+    std::vector<int> sums;
+
+    void SetUp() override { sums.assign(10, 0); }
+    void TearDown() override { EXPECT_EQ(s_Builds.load(), 1); }
+};
+
+TEST_F(Dataset, Sum)
+{
+    EXPECT_EQ(std::accumulate(s_Values->begin(), s_Values->end(), 0), 499500);
+    EXPECT_EQ(sums.size(), 10);
+}
+
+TEST_F(Dataset, Size)
+{
+    EXPECT_EQ(s_Values->size(), 1000);
+    EXPECT_EQ(sums.size(), 10);
+}
+
+PROPERTY(ShouldPass, AddCommutes, EVA::TEST::Int(-1000000, 1000000), EVA::TEST::Int(-1000000, 1000000))
+{
+    EXPECT_EQ(Arg<0>() + Arg<1>(), Arg<1>() + Arg<0>());
+}
+
+PROPERTY(ShouldPass, MaxElement, EVA::TEST::Vector(EVA::TEST::Int<uint8_t>(), 32), EVA::TEST::Bool())
+{
+    const auto& values = Arg<0>();
+    int max            = Arg<1>() ? -1 : -2;
+    for (auto value : values)
+    {
+        max = std::max<int>(max, value);
+    }
+    EXPECT_TRUE(values.empty() || max == *std::max_element(values.begin(), values.end()));
+}
+
+TEST(ShouldPass, Shrink)
+{
+    int value = 123456;
+    EXPECT_TRUE(EVA::TEST::Int(-1000000, 1000000).Shrink(value, [&]() { return value >= 1000; }));
+    EXPECT_EQ(value, 1000);
+
+    value = -5;
+    EXPECT_TRUE(EVA::TEST::Int(-10, 10).Shrink(value, [&]() { return value != 3; }));
+    EXPECT_EQ(value, 0);
+
+    std::vector<int> values = { 5, 2000, 3, 7000, 1 };
+    auto large              = [&]() { return std::any_of(values.begin(), values.end(), [](int v) { return v >= 1000; }); };
+    EXPECT_TRUE(EVA::TEST::Vector(EVA::TEST::Int(0, 10000)).Shrink(values, large));
+    EXPECT_EQ(values, std::vector<int>({ 1000 }));
+
+    double real = 12.75;
+    EXPECT_TRUE(EVA::TEST::Real(-100.0, 100.0).Shrink(real, [&]() { return real > 2.5; }));
+    EXPECT_EQ(real, 12.0);
+}
+
+#if EVA_TEST_HAS_FORK
+TEST(ShouldPass, ProcessPool)
+{
+    std::vector<std::string> results(6);
+    {
+        EVA::TEST::ProcessPool processes(
+            { { 0, 1, 2 }, { 3, 4, 5 } }, { 0, 0, 0, 0, 200, 0 },
+            [](size_t i) {
+                if (i == 1)
+                {
+                    raise(SIGSEGV);
+                }
+                if (i == 4)
+                {
+                    std::this_thread::sleep_for(std::chrono::seconds(10));
+                }
+                return std::to_string(i * i);
+            },
+            [&](size_t i, bool crashed, const std::string& payload) { results[i] = crashed ? "crashed: " + payload : payload; });
+    }
+
+    EXPECT_EQ(results[0], "0");
+    EXPECT_EQ(results[1].rfind("crashed: Crashed with signal", 0), 0);
+    EXPECT_EQ(results[2], "4");
+    EXPECT_EQ(results[3], "9");
+    EXPECT_EQ(results[4], "crashed: Timed out after 200 ms");
+    EXPECT_EQ(results[5], "25");
+}
+#endif
+
 
 TEST(ShouldFail, ET) { EXPECT_TRUE(false); }
 TEST(ShouldFail, EF) { EXPECT_FALSE(true); }
@@ -140,3 +649,79 @@ TEST(ShouldFail, AMEMNQ)
     S b = { 1, 3.0f };
     ASSERT_MEMNQ(&a, &b, sizeof(S));
 }
+
+TEST(ShouldFail, ERANGEEQ)
+{
+    std::vector<int> a(1000000, 1);
+    std::vector<int> b = a;
+    for (size_t i = 0; i < b.size(); i += 10000)
+    {
+        b[i] = 2;
+    }
+    EXPECT_RANGE_EQ(a, b);
+}
+TEST(ShouldFail, ERANGEEQSIZE) { EXPECT_RANGE_EQ(std::vector<int>(3), std::vector<int>(4)); }
+TEST(ShouldFail, ENEARALL) { EXPECT_NEAR_ALL(std::vector<float>({ 1.0f, 2.0f, 3.0f }), std::vector<float>({ 1.0f, 2.5f, 3.0f }), 0.1f); }
+
+TEST(ShouldFail, ARANGEEQ) { ASSERT_RANGE_EQ(std::vector<double>({ 1.0 }), std::vector<double>({ std::nan("") })); }
+TEST(ShouldFail, ANEARALL) { ASSERT_NEAR_ALL(std::vector<float>({ 1.0f }), std::vector<float>({ std::nextafter(std::nextafter(1.0f, 2.0f), 2.0f) }), EVA::TEST::Ulps{ 1 }); }
+
+TEST(ShouldFail, ENOALLOC)
+{
+    EXPECT_NO_ALLOC
+    {
+        std::vector<int> values(8);
+        EVA::TEST::DoNotOptimize(values.data());
+    }
+}
+TEST(ShouldFail, AMAXALLOCS)
+{
+    ASSERT_MAX_ALLOCS(1)
+    {
+        auto first  = std::make_unique<int>(1);
+        auto second = std::make_unique<int>(2);
+        EVA::TEST::DoNotOptimize(first.get());
+        EVA::TEST::DoNotOptimize(second.get());
+    }
+    EXPECT_TRUE(false);
+}
+
+struct FailedSetUp : EVA::TEST::Fixture
+{
+    void SetUp() override { EXPECT_TRUE(false); }
+};
+TEST_F(FailedSetUp, SkipsBody) { EXPECT_FALSE(true); }
+
+// With --repeat, SetUp fails every third run and the body only runs, and passes, in the others
+struct FlakySetUp : EVA::TEST::Fixture
+{
+    inline static std::atomic<int> s_Runs = 0;
+
+    void SetUp() override
+    {
+        int run = s_Runs++;
+        EXPECT_NE(run % 3, 0);
+    }
+};
+TEST_F(FlakySetUp, SkipsBody) { EXPECT_NE((s_Runs - 1) % 3, 0); }
+
+PROPERTY(ShouldFail, PLT, EVA::TEST::Int(0, 1000000), EVA::TEST::Vector(EVA::TEST::Real(-1.0, 1.0)))
+{
+    ASSERT_LT(Arg<0>(), 1000);
+    EXPECT_TRUE(Arg<1>().empty());
+}
+
+TEST(ShouldFail, Flaky)
+{
+    static std::atomic<int> runs = 0;
+    int run                      = runs++;
+    EXPECT_NE(run % 3, 0);
+}
+
+BENCHMARK(ShouldFail, Benchmark)
+{
+    for (auto _ : state)
+    {
+    }
+    EXPECT_TRUE(false);
+}